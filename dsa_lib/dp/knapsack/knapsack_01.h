@@ -2,89 +2,299 @@
 #define KNAPSACK_01_H
 
 #include "template.h"
+#include "thread_pool.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Inner loops dp[j] = max(dp[j], dp[j - w] + v), generic scalar version (branchless)
+template<typename T>
+struct KnapsackRelax {
+    // 0/1 item: j = hi .. w descending
+    static void down(T* dp, int hi, int w, T v) {
+        for (int j = hi; j >= w; --j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    // Unbounded item: j = w .. hi ascending
+    static void up(T* dp, int hi, int w, T v) {
+        for (int j = w; j <= hi; ++j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    // 0/1 item into a second row: dst[j] for j = lo .. hi (src = previous row)
+    static void step(T* dst, const T* src, int lo, int hi, int w, T v) {
+        int j = lo;
+        for (; j <= hi && j < w; ++j) dst[j] = src[j];
+        for (; j <= hi; ++j) dst[j] = max(src[j], src[j - w] + v);
+    }
+};
+
+#ifdef __AVX2__
+// Descending blocks only read cells below the block (not written yet for this item),
+// ascending blocks need w >= lanes so the cells they read are already final.
+template<> struct KnapsackRelax<long long> {
+    static void down(long long* dp, int hi, int w, long long v) {
+        const __m256i vv = _mm256_set1_epi64x(v);
+        int j = hi - 3;
+        for (; j >= w; j -= 4) {
+            __m256i cur = _mm256_loadu_si256((const __m256i*)(dp + j));
+            __m256i cand = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(dp + j - w)), vv);
+            _mm256_storeu_si256((__m256i*)(dp + j), _mm256_blendv_epi8(cur, cand, _mm256_cmpgt_epi64(cand, cur)));
+        }
+        for (j += 3; j >= w; --j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    static void up(long long* dp, int hi, int w, long long v) {
+        int j = w;
+        if (w >= 4) {
+            const __m256i vv = _mm256_set1_epi64x(v);
+            for (; j + 3 <= hi; j += 4) {
+                __m256i cur = _mm256_loadu_si256((const __m256i*)(dp + j));
+                __m256i cand = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(dp + j - w)), vv);
+                _mm256_storeu_si256((__m256i*)(dp + j), _mm256_blendv_epi8(cur, cand, _mm256_cmpgt_epi64(cand, cur)));
+            }
+        }
+        for (; j <= hi; ++j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    static void step(long long* dst, const long long* src, int lo, int hi, int w, long long v) {
+        int j = lo;
+        for (; j <= hi && j < w; ++j) dst[j] = src[j];
+        const __m256i vv = _mm256_set1_epi64x(v);
+        for (; j + 3 <= hi; j += 4) {
+            __m256i cur = _mm256_loadu_si256((const __m256i*)(src + j));
+            __m256i cand = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(src + j - w)), vv);
+            _mm256_storeu_si256((__m256i*)(dst + j), _mm256_blendv_epi8(cur, cand, _mm256_cmpgt_epi64(cand, cur)));
+        }
+        for (; j <= hi; ++j) dst[j] = max(src[j], src[j - w] + v);
+    }
+};
+
+template<> struct KnapsackRelax<int> {
+    static void down(int* dp, int hi, int w, int v) {
+        const __m256i vv = _mm256_set1_epi32(v);
+        int j = hi - 7;
+        for (; j >= w; j -= 8) {
+            __m256i cur = _mm256_loadu_si256((const __m256i*)(dp + j));
+            __m256i cand = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(dp + j - w)), vv);
+            _mm256_storeu_si256((__m256i*)(dp + j), _mm256_max_epi32(cur, cand));
+        }
+        for (j += 7; j >= w; --j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    static void up(int* dp, int hi, int w, int v) {
+        int j = w;
+        if (w >= 8) {
+            const __m256i vv = _mm256_set1_epi32(v);
+            for (; j + 7 <= hi; j += 8) {
+                __m256i cur = _mm256_loadu_si256((const __m256i*)(dp + j));
+                __m256i cand = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(dp + j - w)), vv);
+                _mm256_storeu_si256((__m256i*)(dp + j), _mm256_max_epi32(cur, cand));
+            }
+        }
+        for (; j <= hi; ++j) dp[j] = max(dp[j], dp[j - w] + v);
+    }
+    static void step(int* dst, const int* src, int lo, int hi, int w, int v) {
+        int j = lo;
+        for (; j <= hi && j < w; ++j) dst[j] = src[j];
+        const __m256i vv = _mm256_set1_epi32(v);
+        for (; j + 7 <= hi; j += 8) {
+            __m256i cur = _mm256_loadu_si256((const __m256i*)(src + j));
+            __m256i cand = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(src + j - w)), vv);
+            _mm256_storeu_si256((__m256i*)(dst + j), _mm256_max_epi32(cur, cand));
+        }
+        for (; j <= hi; ++j) dst[j] = max(src[j], src[j - w] + v);
+    }
+};
+#endif
 
 /**
  * Standard 0/1 and Unbounded Knapsack Struct
  * * USAGE: 
- * // 1. Define solver
+ * // 1. Define solver (MAX_W - 1 = default capacity)
  * Knapsack01<200005> ks; 
  * * void solve() {
- * // 2. Solve 0/1 (default)
- * ks.solve(weights, values);
+ * // 2. Solve 0/1 (default), only cells 0..capacity are touched
+ * ks.solve(weights, values, capacity);
  * // OR Solve Unbounded (infinite items)
- * ks.solve_unbounded(weights, values);
+ * ks.solve_unbounded(weights, values, capacity);
+ * // OR 0/1 on several threads (large capacities)
+ * ks.solve_parallel(weights, values, capacity, threads);
  * cout << ks.query(capacity) << endl;
+ * vector<int> take = ks.reconstruct(capacity); // copies of each item used
  * }
+ * * MEMORY: runtime-sized row, the buffer is kept across calls (no MAX_W array,
+ *   a small test after a big one only pays for its own capacity)
+ * * SPEED: branchless inner loop, AVX2 (4 x int64 / 8 x int32 cells) with
+ *   -mavx2 or -march=native. When every reachable total fits in int, a
+ *   long long solver runs the DP on 32-bit cells (twice the lanes).
  * * COMPLEXITY: O(Capacity * N)
  */
 template<int MAX_W, typename T = long long>
 struct Knapsack01 {
-    T dp[MAX_W];
+    int cap;         // Capacity of the last solve
+    vector<T> dp;    // dp[j] = best value with total weight <= j, j <= cap
+    vector<int> d32; // 32-bit scratch row
+    vector<T> buf;   // Second row of solve_parallel
+
+    // Items of the last solve, kept for reconstruct()
+    vector<int> item_w;
+    vector<T> item_v;
+    bool unbounded = false;
 
     // Default Constructor
-    Knapsack01() { reset(); }
+    Knapsack01() { reset(0); }
 
     // Constructor 1: Direct weights and values
     // is_unbounded = false (default): 0/1 Knapsack
     // is_unbounded = true: Unbounded Knapsack
-    Knapsack01(const vector<int>& weights, const vector<T>& values, bool is_unbounded = false) {
-        if (is_unbounded) solve_unbounded(weights, values);
-        else solve(weights, values);
+    Knapsack01(const vector<int>& weights, const vector<T>& values, bool is_unbounded = false,
+               int capacity = MAX_W - 1) {
+        run(weights, values, is_unbounded, capacity);
     }
 
     // Constructor 2: Raw item pairs {{weight, value}, ...}
-    Knapsack01(const vector<pair<int, T>>& items, bool is_unbounded = false) {
+    Knapsack01(const vector<pair<int, T>>& items, bool is_unbounded = false, int capacity = MAX_W - 1) {
         vector<int> w; 
         vector<T> v;
         for(auto& p : items) {
             w.push_back(p.first);
             v.push_back(p.second);
         }
-        if (is_unbounded) solve_unbounded(w, v);
-        else solve(w, v);
+        run(w, v, is_unbounded, capacity);
     }
 
-    void reset() {
-        fill(dp, dp + MAX_W, 0);
+    // Clears cells 0..capacity (keeps the allocation)
+    void reset(int capacity = MAX_W - 1) {
+        cap = capacity;
+        dp.assign(cap + 1, 0);
     }
 
     // Standard 0/1 Knapsack: Each item at most once
-    void solve(const vector<int>& weights, const vector<T>& values) {
-        reset();
-        int n = weights.size();
-        for (int i = 0; i < n; ++i) {
-            int w = weights[i];
-            T v = values[i];
-            if (w == 0 || w >= MAX_W) continue; 
-            for (int j = MAX_W - 1; j >= w; --j) {
-                if (dp[j - w] + v > dp[j]) {
-                    dp[j] = dp[j - w] + v;
-                }
+    void solve(const vector<int>& weights, const vector<T>& values, int capacity = MAX_W - 1) {
+        run(weights, values, false, capacity);
+    }
+
+    // Unbounded Knapsack: Each item infinite times
+    void solve_unbounded(const vector<int>& weights, const vector<T>& values, int capacity = MAX_W - 1) {
+        run(weights, values, true, capacity);
+    }
+
+    // Items with value <= 0 never improve dp (dp is non-decreasing in j) and are skipped
+    void run(const vector<int>& weights, const vector<T>& values, bool is_unbounded, int capacity = MAX_W - 1) {
+        reset(capacity);
+        item_w = weights;
+        item_v = values;
+        unbounded = is_unbounded;
+        if constexpr (is_integral<T>::value && sizeof(T) > sizeof(int)) {
+            if (fits_int(weights, values, is_unbounded)) {
+                d32.assign(cap + 1, 0);
+                relax_all(d32.data(), weights, values, is_unbounded);
+                copy(d32.begin(), d32.end(), dp.begin());
+                return;
             }
         }
+        relax_all(dp.data(), weights, values, is_unbounded);
     }
 
-    // Unbounded Knapsack: Each item infinite times
-    void solve_unbounded(const vector<int>& weights, const vector<T>& values) {
-        reset();
+    // 0/1 Knapsack on 'threads' threads (0 = all cores). The row is double-buffered:
+    // new[j] = max(old[j], old[j - w] + v) only reads the previous row, so every item
+    // is one parallel step over contiguous j-blocks followed by a barrier.
+    // Worth it for large capacities (a block should be >> 10^4 cells).
+    void solve_parallel(const vector<int>& weights, const vector<T>& values, int capacity = MAX_W - 1,
+                        int threads = 0) {
+        ThreadPool pool(threads);
+        if (pool.n == 1) { solve(weights, values, capacity); return; }
+        reset(capacity);
+        item_w = weights;
+        item_v = values;
+        unbounded = false;
+        buf.assign(cap + 1, 0);
+        int n = weights.size(), steps = 0;
+        for (int i = 0; i < n; ++i) steps += weights[i] > 0 && weights[i] <= cap && values[i] > 0;
+
+        pool.run([&](int tid) {
+            auto [lo, hi] = pool.block(cap + 1, tid);
+            T *a = dp.data(), *b = buf.data();
+            for (int i = 0; i < n; ++i) {
+                int w = weights[i];
+                if (w == 0 || w > cap || values[i] <= 0) continue;
+                KnapsackRelax<T>::step(b, a, lo, hi - 1, w, values[i]);
+                swap(a, b);
+                pool.sync();
+            }
+        });
+        if (steps & 1) dp.swap(buf);
+    }
+
+    // Best total <= sum of values (0/1) or <= cap * max(v / w) (unbounded)
+    bool fits_int(const vector<int>& weights, const vector<T>& values, bool is_unbounded) const {
+        __int128 total = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            int w = weights[i];
+            if (w == 0 || w > cap || values[i] <= 0) continue;
+            if (is_unbounded) {
+                if ((__int128)values[i] * cap > (__int128)INT_MAX * w) return false;
+            } else if ((total += values[i]) > INT_MAX) return false;
+        }
+        return true;
+    }
+
+    template<typename U>
+    void relax_all(U* d, const vector<int>& weights, const vector<T>& values, bool is_unbounded) const {
         int n = weights.size();
         for (int i = 0; i < n; ++i) {
             int w = weights[i];
-            T v = values[i];
-            if (w == 0 || w >= MAX_W) continue;
-            for (int j = w; j < MAX_W; ++j) {
-                if (dp[j - w] + v > dp[j]) {
-                    dp[j] = dp[j - w] + v;
-                }
-            }
+            if (w == 0 || w > cap || values[i] <= 0) continue;
+            U v = values[i];
+            if (is_unbounded) KnapsackRelax<U>::up(d, cap, w, v);
+            else KnapsackRelax<U>::down(d, cap, w, v);
         }
     }
 
     T query(int k) const {
         if (k < 0) return 0;
-        if (k >= MAX_W) return dp[MAX_W - 1];
+        if (k > cap) return dp[cap];
         return dp[k];
     }
+
+    // --- Reconstruction (Hirschberg-style) ---
+    // Multiplicity of every item in an optimal solution for 'capacity' (0/1 or
+    // unbounded, as last solved). Items are halved recursively: the best
+    // capacity split c between the halves maximises F[c] + G[capacity - c],
+    // F / G being the rows of each half. Both rows are freed before recursing.
+    // Time O(N * Capacity) (2x a solve), memory O(Capacity + N).
+    vector<int> reconstruct(int capacity) const {
+        vector<int> take(item_w.size(), 0);
+        capacity = min(capacity, cap);
+        if (capacity > 0) split_items(0, item_w.size(), capacity, take);
+        return take;
+    }
+
+    void split_items(int lo, int hi, int C, vector<int>& take) const {
+        if (hi - lo == 1) {
+            int w = item_w[lo];
+            if (w > 0 && w <= C && item_v[lo] > 0) take[lo] = unbounded ? C / w : 1;
+            return;
+        }
+        if (hi <= lo || C == 0) return;
+        int mid = lo + (hi - lo) / 2, best = 0;
+        {
+            vector<T> f = best_row(lo, mid, C), g = best_row(mid, hi, C);
+            for (int c = 1; c <= C; ++c) {
+                if (f[c] + g[C - c] > f[best] + g[C - best]) best = c;
+            }
+        }
+        split_items(lo, mid, best, take);
+        split_items(mid, hi, C - best, take);
+    }
+
+    // dp row over items [lo, hi) for capacities 0..C
+    vector<T> best_row(int lo, int hi, int C) const {
+        vector<T> d(C + 1, 0);
+        for (int i = lo; i < hi; ++i) {
+            int w = item_w[i];
+            if (w == 0 || w > C || item_v[i] <= 0) continue;
+            if (unbounded) KnapsackRelax<T>::up(d.data(), C, w, item_v[i]);
+            else KnapsackRelax<T>::down(d.data(), C, w, item_v[i]);
+        }
+        return d;
+    }
 };
 
 #endif
@@ -99,12 +309,18 @@ void solve(){
     vi w(n); vl v(n);
     for(int i=0; i<n; ++i) cin >> w[i] >> v[i];
 
-    // Template arg <10005> must be > capacity
-    Knapsack01<10005> ks(w, v); 
+    // Runtime capacity (template arg only sets the default)
+    Knapsack01<10005> ks;
+    ks.solve(w, v, capacity);
     
     // For infinite items:
-    // ks.solve_unbounded(w, v);
+    // ks.solve_unbounded(w, v, capacity);
 
     cout << ks.query(capacity) << "\n";
+
+    // Chosen items (O(capacity + n) memory)
+    vi take = ks.reconstruct(capacity);
+    for(int i=0; i<n; ++i) if(take[i]) cout << i << " ";
+    cout << "\n";
 }
 */
\ No newline at end of file
@@ -6,73 +6,109 @@
 /**
  * Optimized Bitset Knapsack Struct
  * * USAGE: 
- * // 1. Define global solver (efficient memory reuse)
+ * // 1. Define global solver (efficient memory reuse, MAX_W - 1 = default capacity)
  * Knapsack<200005> ks; 
  * * void solve() {
- * // 2. Solve for specific items
- * ks.solve(weights, counts);
+ * // 2. Solve for specific items, sums above 'capacity' are not tracked
+ * ks.solve(weights, counts, target);
  * if (ks.possible(target)) ...
+ * // 3. OR yes/no for one target only: stops as soon as it is reached
+ * ks.solve(weights, counts, target, true);
  * }
- * * COMPLEXITY: O(Target * N / 64)
+ * * MEMORY: runtime-sized bitset of capacity / 64 + 1 words, kept across calls;
+ *   shifts only touch the words below min(capacity, running total weight)
+ * * COMPLEXITY: O(Target * N / 64), O(Target * sqrt(S) / 64) from raw items of sum S
  */
 template<int MAX_W>
 struct Knapsack {
-    bitset<MAX_W> dp;
+    int cap;                        // Capacity of the last solve
+    vector<unsigned long long> dp;  // Bit s = sum s reachable (s <= cap is meaningful)
 
     // Default Constructor: useful for global declaration
-    Knapsack() { dp.reset(); }
+    Knapsack() { reset(0); }
 
     // Constructor 1: Direct weights and counts
-    Knapsack(const vector<int>& weights, const vector<int>& counts) {
-        solve(weights, counts);
+    Knapsack(const vector<int>& weights, const vector<int>& counts, int capacity = MAX_W - 1) {
+        solve(weights, counts, capacity);
     }
 
     // Constructor 2: Raw item list {2, 5, 2, 2, 5}
-    // Auto-compresses to: 2->3, 5->2
-    Knapsack(vector<int> items) { // Pass-by-value to sort internally
-        sort(items.begin(), items.end());
-        vector<int> w, c;
-        if (!items.empty()) {
-            w.push_back(items[0]);
-            c.push_back(1);
-            for (size_t i = 1; i < items.size(); ++i) {
-                if (items[i] == items[i-1]) {
-                    c.back()++;
-                } else {
-                    w.push_back(items[i]);
-                    c.push_back(1);
-                }
-            }
+    // Auto-compresses to: 2->2, 5->2 (see solve_items)
+    Knapsack(const vector<int>& items, int capacity = MAX_W - 1) {
+        solve_items(items, capacity);
+    }
+
+    // Only sum 0 reachable, words for 0..capacity (keeps the allocation)
+    void reset(int capacity = MAX_W - 1) {
+        cap = capacity;
+        dp.assign(cap / 64 + 1, 0);
+        dp[0] = 1;
+    }
+
+    // dp |= dp << s for bits 0..hi, one descending pass over words 0..hi/64
+    // (bits past 'hi' in the top word are junk that never moves down)
+    void shift_or(long long s, int hi) {
+        if (s > hi) return;
+        int top = hi >> 6, q = s >> 6, r = s & 63;
+        if (r == 0) {
+            for (int i = top; i >= q; --i) dp[i] |= dp[i - q];
+        } else {
+            for (int i = top; i > q; --i) dp[i] |= (dp[i - q] << r) | (dp[i - q - 1] >> (64 - r));
+            dp[q] |= dp[0] << r;
         }
-        solve(w, c);
     }
 
     // Main Solver
-    void solve(const vector<int>& weights, const vector<int>& counts) {
-        dp.reset();
-        dp[0] = 1;
+    // Shifts stop at the running total of the weights added so far (no bit above it
+    // can be set). early_exit = true: stop as soon as 'capacity' itself is reachable
+    // (then only possible(capacity) is meaningful).
+    void solve(const vector<int>& weights, const vector<int>& counts, int capacity = MAX_W - 1,
+               bool early_exit = false) {
+        reset(capacity);
+        long long total = 0;
         int n = weights.size();
         for (int i = 0; i < n; ++i) {
             int w = weights[i];
             int c = counts[i];
             if (w == 0) continue;
-            if (w >= MAX_W) continue;
+            if (w > cap) continue;
+            c = min(c, cap / w); // More copies never fit
             
             for (int k = 1; c > 0; k <<= 1) {
                 int take = min(k, c);
-                long long shift = 1LL * w * take;
-                
-                if (shift < MAX_W) {
-                    dp |= (dp << shift);
-                }
+                total += 1LL * w * take;
+                shift_or(1LL * w * take, min<long long>(total, cap));
+                if (early_exit && possible(cap)) return;
                 c -= take;
             }
         }
     }
 
+    // Raw items (sum S): copies beyond two of a weight x are carried as pairs
+    // into weight 2x, ascending. Every weight is left with count <= 2 and
+    // only O(sqrt S) items remain -> O(Target * sqrt(S) / 64).
+    void solve_items(const vector<int>& items, int capacity = MAX_W - 1, bool early_exit = false) {
+        vector<int> cnt(capacity + 1, 0);
+        for (int x : items) {
+            if (x > 0 && x <= capacity) cnt[x]++;
+        }
+        vector<int> w, c;
+        for (int x = 1; x <= capacity; ++x) {
+            if (!cnt[x]) continue;
+            if (cnt[x] > 2) {
+                int carry = (cnt[x] - 1) / 2; // keeps 1 or 2 copies: every multiple still reachable
+                if (2LL * x <= capacity) cnt[2 * x] += carry;
+                cnt[x] -= 2 * carry;
+            }
+            w.push_back(x);
+            c.push_back(cnt[x]);
+        }
+        solve(w, c, capacity, early_exit);
+    }
+
     bool possible(int k) const {
-        if (k < 0 || k >= MAX_W) return false;
-        return dp[k];
+        if (k < 0 || k > cap) return false;
+        return dp[k >> 6] >> (k & 63) & 1;
     }
 };
 
@@ -89,8 +125,8 @@ void solve(){
     vi items(n);
     for(int &x : items) cin >> x;
 
-    // The template arg <200005> must be >= k
-    Knapsack<200005> ks(items); 
+    // Runtime capacity: only sums up to k are tracked
+    Knapsack<200005> ks(items, k);
 
     if(ks.possible(k)) cout << "YES\n";
     else cout << "NO\n";
@@ -98,6 +134,6 @@ void solve(){
     // CASE B: You have weights and counts (e.g., weight 5 appears 3 times)
     // vi weights = {5, 10};
     // vi counts = {3, 1};
-    // Knapsack<200005> ks2(weights, counts);
+    // Knapsack<200005> ks2(weights, counts, k);
 }
 */
\ No newline at end of file
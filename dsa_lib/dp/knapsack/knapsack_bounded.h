@@ -2,34 +2,44 @@
 #define KNAPSACK_BOUNDED_H
 
 #include "template.h"
+#include "thread_pool.h"
 
 /**
  * Optimized Bounded Knapsack Struct (Value Maximization)
  * * USAGE: 
- * // 1. Define solver with Max Capacity
+ * // 1. Define solver (MAX_W - 1 = default capacity)
  * BoundedKnapsack<200005> ks; 
  * * void solve() {
- * // 2. Solve for specific items
- * ks.solve(weights, values, counts);
+ * // 2. Solve for specific items, only cells 0..capacity are touched
+ * ks.solve(weights, values, counts, capacity);
+ * // OR on several threads (large capacities)
+ * ks.solve_parallel(weights, values, counts, capacity, threads);
  * cout << ks.query(capacity) << endl;
  * }
- * * COMPLEXITY: O(Capacity * N * log(Count))
+ * * MEMORY: runtime-sized row, the buffer is kept across calls
+ * * COMPLEXITY: O(Capacity * N) for large counts (monotone queue),
+ *   O(Capacity * N * log(Count)) binary splitting for small ones
  */
 template<int MAX_W, typename T = long long>
 struct BoundedKnapsack {
-    T dp[MAX_W];
+    int cap;      // Capacity of the last solve
+    vector<T> dp; // dp[j] = best value with total weight <= j, j <= cap
+    vector<int> q_idx; // Monotone deque scratch (reused)
+    vector<T> q_val;
+    vector<T> buf;     // Second row of solve_parallel
 
     // Default Constructor: useful for global declaration
-    BoundedKnapsack() { reset(); }
+    BoundedKnapsack() { reset(0); }
 
     // Constructor 1: Direct weights, values, and counts
-    BoundedKnapsack(const vector<int>& weights, const vector<T>& values, const vector<int>& counts) {
-        solve(weights, values, counts);
+    BoundedKnapsack(const vector<int>& weights, const vector<T>& values, const vector<int>& counts,
+                    int capacity = MAX_W - 1) {
+        solve(weights, values, counts, capacity);
     }
 
     // Constructor 2: Raw item list {{weight, value}, {weight, value}...}
     // Auto-compresses duplicate items (same weight AND same value)
-    BoundedKnapsack(vector<pair<int, T>> items) { 
+    BoundedKnapsack(vector<pair<int, T>> items, int capacity = MAX_W - 1) {
         sort(items.begin(), items.end());
         vector<int> w, c;
         vector<T> v;
@@ -49,42 +59,136 @@ struct BoundedKnapsack {
                 }
             }
         }
-        solve(w, v, c);
+        solve(w, v, c, capacity);
     }
 
-    // Reset DP table
-    void reset() {
-        // Use fill instead of memset for non-POD types support, though usually T=long long
-        fill(dp, dp + MAX_W, 0); 
+    // Reset DP table: cells 0..capacity (keeps the allocation)
+    void reset(int capacity = MAX_W - 1) {
+        cap = capacity;
+        dp.assign(cap + 1, 0);
     }
 
-    // Main Solver
-    void solve(const vector<int>& weights, const vector<T>& values, const vector<int>& counts) {
-        reset();
+    // Main Solver: picks per item
+    //  - c copies cover the whole capacity -> one unbounded pass, O(cap)
+    //  - many copies (> MONOTONE_LOG binary chunks) -> monotone queue, O(cap)
+    //  - few copies -> binary splitting, O(cap * log c) with a tighter loop
+    void solve(const vector<int>& weights, const vector<T>& values, const vector<int>& counts,
+               int capacity = MAX_W - 1) {
+        reset(capacity);
         int n = weights.size();
         for (int i = 0; i < n; ++i) {
             int w = weights[i];
             T val = values[i];
             int c = counts[i];
-            if (w == 0 || w >= MAX_W) continue;
-            for (int k = 1; c > 0; k <<= 1) {
-                int take = min(k, c);
-                int dw = w * take;
-                T dv = val * take;
-                for (int j = MAX_W - 1; j >= dw; --j) {
-                    if (dp[j - dw] + dv > dp[j]) {
-                        dp[j] = dp[j - dw] + dv;
-                    }
+            if (w == 0 || w > cap || c <= 0) continue;
+            if (c >= cap / w) add_unbounded(w, val);
+            else if (32 - __builtin_clz(c) > MONOTONE_LOG) add_monotone(dp.data(), w, val, c, 0, w, q_idx, q_val);
+            else add_binary(w, val, c);
+        }
+    }
+
+    static constexpr int MONOTONE_LOG = 4;
+
+    void add_unbounded(int w, T val) {
+        for (int j = w; j <= cap; ++j) {
+            if (dp[j - w] + val > dp[j]) {
+                dp[j] = dp[j - w] + val;
+            }
+        }
+    }
+
+    void add_binary(int w, T val, int c) {
+        for (int k = 1; c > 0; k <<= 1) {
+            int take = min(k, c);
+            int dw = w * take;
+            T dv = val * take;
+            for (int j = cap; j >= dw; --j) {
+                if (dp[j - dw] + dv > dp[j]) {
+                    dp[j] = dp[j - dw] + dv;
                 }
-                c -= take;
             }
+            c -= take;
         }
     }
 
+    // Per residue r of w: d[r + k*w] = max_{k-c <= t <= k} (d[r + t*w] - t*val) + k*val,
+    // a sliding-window max kept in a monotone deque (in place, old value read before write).
+    // Residues [r_lo, r_hi) touch disjoint cells, so threads can split them.
+    void add_monotone(T* d, int w, T val, int c, int r_lo, int r_hi, vector<int>& qi, vector<T>& qv) const {
+        int len = cap / w + 1;
+        qi.resize(len);
+        qv.resize(len);
+        for (int r = r_lo; r < r_hi; ++r) {
+            int head = 0, tail = 0;
+            for (int k = 0, j = r; j <= cap; ++k, j += w) {
+                T cur = d[j] - val * k;
+                while (tail > head && qv[tail - 1] <= cur) --tail;
+                qi[tail] = k;
+                qv[tail++] = cur;
+                if (qi[head] < k - c) ++head;
+                d[j] = qv[head] + val * k;
+            }
+        }
+    }
+
+    // Solver on 'threads' threads (0 = all cores), same choice per item as solve():
+    //  - binary chunks: double-buffered row (new[j] reads only the previous row),
+    //    contiguous j-blocks per thread
+    //  - unbounded / monotone items: residue classes of w split across threads, in place
+    // One barrier per row step. Worth it for large capacities.
+    void solve_parallel(const vector<int>& weights, const vector<T>& values, const vector<int>& counts,
+                        int capacity = MAX_W - 1, int threads = 0) {
+        ThreadPool pool(threads);
+        if (pool.n == 1) { solve(weights, values, counts, capacity); return; }
+        reset(capacity);
+        buf.assign(cap + 1, 0);
+        int n = weights.size();
+        T* final_row = dp.data();
+
+        pool.run([&](int tid) {
+            auto [lo, hi] = pool.block(cap + 1, tid);
+            vector<int> qi;
+            vector<T> qv;
+            T *a = dp.data(), *b = buf.data();
+            for (int i = 0; i < n; ++i) {
+                int w = weights[i];
+                T val = values[i];
+                int c = counts[i];
+                if (w == 0 || w > cap || c <= 0) continue;
+                bool full = c >= cap / w;
+                if (full || 32 - __builtin_clz(c) > MONOTONE_LOG) {
+                    auto [r_lo, r_hi] = pool.block(w, tid);
+                    if (full) {
+                        for (int r = r_lo; r < r_hi; ++r) {
+                            for (int j = r + w; j <= cap; j += w) a[j] = max(a[j], a[j - w] + val);
+                        }
+                    } else {
+                        add_monotone(a, w, val, c, r_lo, r_hi, qi, qv);
+                    }
+                    pool.sync();
+                    continue;
+                }
+                for (int k = 1; c > 0; k <<= 1) {
+                    int take = min(k, c);
+                    int dw = w * take;
+                    T dv = val * take;
+                    int j = lo;
+                    for (; j < hi && j < dw; ++j) b[j] = a[j];
+                    for (; j < hi; ++j) b[j] = max(a[j], a[j - dw] + dv);
+                    swap(a, b);
+                    pool.sync();
+                    c -= take;
+                }
+            }
+            if (tid == 0) final_row = a;
+        });
+        if (final_row != dp.data()) dp.swap(buf);
+    }
+
     // Query: Max value for capacity 'k'
     T query(int k) const {
         if (k < 0) return 0;
-        if (k >= MAX_W) return dp[MAX_W - 1];
+        if (k > cap) return dp[cap];
         return dp[k];
     }
 };
@@ -101,7 +205,7 @@ void solve(){
     // CASE A: Raw items (e.g., pairs of {weight, value})
     // vector<pair<int, ll>> items(n);
     // for(auto &x : items) cin >> x.first >> x.second;
-    // BoundedKnapsack<10005> ks(items);
+    // BoundedKnapsack<10005> ks(items, capacity);
     // cout << ks.query(capacity) << "\n";
 
     // CASE B: Distinct weights/values with counts
@@ -109,8 +213,8 @@ void solve(){
     vl v(n);
     for(int i=0; i<n; ++i) cin >> w[i] >> v[i] >> c[i];
 
-    // Template arg <10005> must be > capacity
-    BoundedKnapsack<10005> ks(w, v, c); 
+    // Runtime capacity (template arg only sets the default)
+    BoundedKnapsack<10005> ks(w, v, c, capacity);
 
     cout << ks.query(capacity) << "\n";
 }
@@ -6,19 +6,25 @@
 /**
  * Reconstructable Knapsack Struct
  * * USAGE:
- * KnapsackReconstruct<MAX_W> ks(weights, counts);
+ * KnapsackReconstruct<MAX_W> ks(weights, counts, capacity); // capacity defaults to MAX_W - 1
  * if (ks.possible(target)) {
  * // Returns map: { original_item_index -> quantity_used }
  * map<int, int> solution = ks.reconstruct(target);
  * }
- * * MEMORY: Uses sizeof(int) * MAX_W bytes (32x more than bitset).
- * * COMPLEXITY: O(Target * N * log(Count))
+ * * SPEED: the DP itself runs on a bitset (like Knapsack). Per word,
+ *   diff = (dp << w) & ~dp holds the sums this batch reaches first; only
+ *   those bits are visited (ctz) to fill from_item.
+ * * MEMORY: Uses sizeof(int) * (capacity + 1) bytes (32x more than bitset),
+ *   runtime-sized and kept across calls.
+ * * COMPLEXITY: O(Target * N * log(Count) / 64 + Target)
  */
 template<int MAX_W>
 struct KnapsackReconstruct {
     // Stores the index of the decomposed item used to reach sum 's'.
     // -1 = Unreachable, -2 = Start
-    int from_item[MAX_W];
+    int cap;                // Capacity of the last solve
+    vector<int> from_item;  // size cap + 1
+    vector<unsigned long long> reach; // Bit s = from_item[s] != -1
     
     // Metadata for decomposed items (Binary parts: 1, 2, 4...)
     struct DecomposedItem {
@@ -29,28 +35,49 @@ struct KnapsackReconstruct {
     vector<DecomposedItem> items_meta;
 
     // Constructors
-    KnapsackReconstruct() { reset(); }
+    KnapsackReconstruct() { reset(0); }
 
-    KnapsackReconstruct(const vector<int>& weights, const vector<int>& counts) {
-        solve(weights, counts);
+    KnapsackReconstruct(const vector<int>& weights, const vector<int>& counts, int capacity = MAX_W - 1) {
+        solve(weights, counts, capacity);
     }
 
-    void reset() {
-        fill(from_item, from_item + MAX_W, -1);
+    void reset(int capacity = MAX_W - 1) {
+        cap = capacity;
+        from_item.assign(cap + 1, -1);
         from_item[0] = -2; 
+        reach.assign(cap / 64 + 1, 0);
+        reach[0] = 1;
         items_meta.clear();
     }
 
-    void solve(const vector<int>& weights, const vector<int>& counts) {
-        reset();
+    // reach |= reach << s for bits 0..hi (descending, in place);
+    // bits set for the first time record 'id' in from_item
+    void shift_or(int s, int hi, int id) {
+        int top = hi >> 6, q = s >> 6, r = s & 63;
+        unsigned long long top_mask = (hi & 63) == 63 ? ~0ULL : (2ULL << (hi & 63)) - 1;
+        for (int i = top; i >= q; --i) {
+            unsigned long long sh = reach[i - q];
+            if (r) sh = (sh << r) | (i > q ? reach[i - q - 1] >> (64 - r) : 0);
+            unsigned long long diff = sh & ~reach[i];
+            if (i == top) diff &= top_mask;
+            if (!diff) continue;
+            reach[i] |= diff;
+            for (; diff; diff &= diff - 1) from_item[i * 64 + __builtin_ctzll(diff)] = id;
+        }
+    }
+
+    void solve(const vector<int>& weights, const vector<int>& counts, int capacity = MAX_W - 1) {
+        reset(capacity);
         int n = weights.size();
         int current_id = 0; // ID for each decomposed part
+        long long total = 0; // No sum above the running total is reachable yet
 
         for (int i = 0; i < n; ++i) {
             int w = weights[i];
             int c = counts[i];
 
-            if (w == 0 || w >= MAX_W) continue;
+            if (w == 0 || w > cap) continue;
+            c = min(c, cap / w); // More copies never fit
 
             // Binary Decomposition (1, 2, 4...)
             for (int k = 1; c > 0; k <<= 1) {
@@ -59,13 +86,9 @@ struct KnapsackReconstruct {
                 
                 items_meta.push_back({batch_weight, i, take});
 
-                // Standard 0/1 DP (Reverse order to prevent reusing same batch)
-                for (int s = MAX_W - 1; s >= batch_weight; --s) {
-                    // If current sum 's' is not yet reached, but 's - weight' is:
-                    if (from_item[s] == -1 && from_item[s - batch_weight] != -1) {
-                        from_item[s] = current_id;
-                    }
-                }
+                // 0/1 step on the bitset: s gets this batch iff s - weight was reached before it
+                total += batch_weight;
+                shift_or(batch_weight, min<long long>(total, cap), current_id);
                 
                 c -= take;
                 current_id++;
@@ -75,7 +98,7 @@ struct KnapsackReconstruct {
 
     // Check reachability
     bool possible(int k) const {
-        if (k < 0 || k >= MAX_W) return false;
+        if (k < 0 || k > cap) return false;
         return from_item[k] != -1;
     }
 
@@ -109,8 +132,8 @@ void solve() {
     vi w(n), c(n);
     for(int i=0; i<n; ++i) cin >> w[i] >> c[i];
 
-    // Must be large enough for target
-    KnapsackReconstruct<200005> ks(w, c);
+    // Runtime capacity (template arg only sets the default)
+    KnapsackReconstruct<200005> ks(w, c, target);
 
     if (ks.possible(target)) {
         cout << "Possible\n";
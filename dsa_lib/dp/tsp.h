@@ -2,37 +2,116 @@
 #define TRAVELLING_SALESMAN_H
 
 #include "template.h"
+#include "thread_pool.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// min over u < m of a[u] + b[u], generic scalar version
+template<typename T>
+struct TSPMinPlus {
+    static T run(const T* a, const T* b, int m, T best) {
+        for (int u = 0; u < m; ++u) best = min(best, a[u] + b[u]);
+        return best;
+    }
+};
+
+#ifdef __AVX2__
+template<> struct TSPMinPlus<long long> {
+    static long long run(const long long* a, const long long* b, int m, long long best) {
+        int u = 0;
+        if (m >= 4) {
+            __m256i acc = _mm256_set1_epi64x(best);
+            for (; u + 3 < m; u += 4) {
+                __m256i s = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(a + u)),
+                                             _mm256_loadu_si256((const __m256i*)(b + u)));
+                acc = _mm256_blendv_epi8(acc, s, _mm256_cmpgt_epi64(acc, s));
+            }
+            alignas(32) long long lane[4];
+            _mm256_store_si256((__m256i*)lane, acc);
+            best = min(min(lane[0], lane[1]), min(lane[2], lane[3]));
+        }
+        for (; u < m; ++u) best = min(best, a[u] + b[u]);
+        return best;
+    }
+};
+
+template<> struct TSPMinPlus<int> {
+    static int run(const int* a, const int* b, int m, int best) {
+        int u = 0;
+        if (m >= 8) {
+            __m256i acc = _mm256_set1_epi32(best);
+            for (; u + 7 < m; u += 8) {
+                acc = _mm256_min_epi32(acc, _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(a + u)),
+                                                             _mm256_loadu_si256((const __m256i*)(b + u))));
+            }
+            __m128i x = _mm_min_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            x = _mm_min_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+            x = _mm_min_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+            best = _mm_cvtsi128_si32(x);
+        }
+        for (; u < m; ++u) best = min(best, a[u] + b[u]);
+        return best;
+    }
+};
+#endif
 
 /**
  * Travelling Salesman Problem (TSP) & Hamiltonian Path Solver using Bitmask DP
  * * * USAGE:
- * // 1. Define solver (Max Nodes usually <= 20)
- * TSP<20> tsp(n); 
+ * // 1. Define solver (MAX_N = upper bound on nodes, tables are sized by the real n)
+ * TSP<20> tsp(n);
  * * // 2. Add edges (u, v, cost) - supports directed/undirected
  * for(auto& e : edges) tsp.add_edge(e.u, e.v, e.w);
  * * // 3. Solve
  * // A. Round Trip (Cycle): Start -> All Nodes -> Start
- * long long cost = tsp.solve_tour(0); 
+ * long long cost = tsp.solve_tour(0);
  * * // B. Open Path: Start -> All Nodes -> Specific End (or -1 for any)
  * long long cost = tsp.solve_path(0, -1);
+ * * // C. Either one on several threads (0 = all cores), for large n
+ * long long cost = tsp.solve_tour(0, 8);
  * * // 4. Get the actual path
  * vector<int> path = tsp.reconstruct_path();
- * * * COMPLEXITY: 
- * Time: O(N^2 * 2^N)
- * Space: O(N * 2^N)
+ * * * LAYOUT: the start node is fixed, so states are subsets of the other m = n - 1
+ *   nodes: dp[mask * m + v] = cheapest path start -> (all of mask) ending at v.
+ *   Pull form dp[mask][v] = min_u dp[mask ^ v][u] + dist[u][v] reads one contiguous
+ *   row and one contiguous column of the transposed distance matrix (AVX2 min-plus
+ *   with -march=native); rows of states that cannot exist are INF, so no bit tests.
+ * * THREADS: a mask only reads masks with one bit less. Masks are grouped by their
+ *   top 12 bits into blocks of consecutive rows; blocks whose top bits have the same
+ *   popcount are independent, so each such layer (enumerated with Gosper's hack) is
+ *   one ThreadPool::for_each with work stealing. Rows inside a block keep the serial
+ *   order and its cache locality. Same tables and result as 1 thread.
+ * * PARENTS: off by default, reconstruct_path() re-derives each step from dp in O(n).
+ *   TSP<N> tsp(n, true) keeps a uint8_t parent per state instead.
+ * * COMPLEXITY:
+ * Time: O(N^2 * 2^N) (about a quarter of the full 2^N * N table is visited)
+ * Space: O(N * 2^(N-1)) cells of T (+ as many bytes with parents)
  */
 template<int MAX_N, typename T = long long>
 struct TSP {
-    T dp[1 << MAX_N][MAX_N];
-    int parent[1 << MAX_N][MAX_N];
+    static_assert(MAX_N <= 32, "states are 32-bit masks");
+    static constexpr int HIGH_BITS = 12; // Parallel DP: up to 2^12 blocks, layered by these bits
+
     T dist[MAX_N][MAX_N];
     int n;
     int start_node;
     int end_node_req;
     bool is_tour;
+    bool store_parent;
     const T INF = numeric_limits<T>::max() / 4;
 
-    TSP(int nodes) : n(nodes) {
+    // Tables of the last solve (m = n - 1 nodes besides the start)
+    int m;
+    vector<int> node;       // node[i] = graph node of DP index i
+    vector<int> idx;        // idx[node[i]] = i, idx[start] = -1
+    vector<T> dt;           // dt[v * m + u] = dist[node[u]][node[v]]
+    vector<T> dp;           // dp[mask * m + v]
+    vector<uint8_t> parent; // parent[mask * m + v] = u (only with store_parent)
+    T lim;                  // Sums >= lim contain an INF edge
+
+    TSP(int nodes, bool keep_parent = false) : n(nodes), store_parent(keep_parent) {
         for(int i = 0; i < MAX_N; ++i) {
             for(int j = 0; j < MAX_N; ++j) {
                 dist[i][j] = (i == j) ? 0 : INF;
@@ -45,75 +124,140 @@ struct TSP {
         if (!directed) dist[v][u] = min(dist[v][u], w);
     }
 
-    void _reset_dp() {
-        for(int mask = 0; mask < (1 << n); ++mask) {
-            for(int i = 0; i < n; ++i) {
-                dp[mask][i] = INF;
-                parent[mask][i] = -1;
-            }
+    // Relabels the non-start nodes to 0..m-1 and transposes their distances
+    void _prepare(int start) {
+        start_node = start;
+        m = n - 1;
+        node.clear();
+        idx.assign(n, -1);
+        for (int i = 0; i < n; ++i) {
+            if (i == start) continue;
+            idx[i] = node.size();
+            node.push_back(i);
         }
+        dt.resize((size_t)m * m);
+        T lo = 0;
+        for (int v = 0; v < m; ++v)
+            for (int u = 0; u < m; ++u) lo = min(lo, dt[(size_t)v * m + u] = dist[node[u]][node[v]]);
+        for (int i = 0; i < n; ++i) lo = min(lo, dist[start][i]);
+        lim = INF + lo * m;
     }
 
-    void _run_dp(int start) {
-        _reset_dp();
-        start_node = start;
-        dp[1 << start][start] = 0;
-        for (int mask = 1; mask < (1 << n); ++mask) {
-            for (int u = 0; u < n; ++u) {
-                if (!((mask >> u) & 1) || dp[mask][u] == INF) continue;
-                for (int v = 0; v < n; ++v) {
-                    if ((mask >> v) & 1) continue;
-                    if (dist[u][v] != INF) {
-                        int next_mask = mask | (1 << v);
-                        if (dp[mask][u] + dist[u][v] < dp[next_mask][v]) {
-                            dp[next_mask][v] = dp[mask][u] + dist[u][v];
-                            parent[next_mask][v] = u;
-                        }
+    // Fills row 'mask' (popcount >= 2) from the rows of its subsets
+    void _pull(unsigned mask) {
+        T* row = &dp[(size_t)mask * m];
+        for (int v = 0; v < m; ++v) {
+            if (!((mask >> v) & 1)) { row[v] = INF; continue; }
+            const T* prev = &dp[(size_t)(mask ^ (1u << v)) * m];
+            const T* col = &dt[(size_t)v * m];
+            T best = TSPMinPlus<T>::run(prev, col, m, INF);
+            if (best >= lim) best = INF; // Went through an INF cell (only < INF with negative edges)
+            row[v] = best;
+            if (store_parent) parent[(size_t)mask * m + v] = _arg(prev, col, best);
+        }
+    }
+
+    // First u with prev[u] + col[u] == best (best < INF)
+    int _arg(const T* prev, const T* col, T best) const {
+        if (best >= INF) return 0;
+        int u = 0;
+        while (prev[u] + col[u] != best) ++u;
+        return u;
+    }
+
+    // threads != 1: blocked popcount layers on a ThreadPool (0 = all cores)
+    void _run_dp(int start, int threads = 1) {
+        _prepare(start);
+        size_t states = (size_t)1 << m;
+        // Rows with popcount >= 2 are fully rewritten: a re-solve keeps the tables
+        dp.resize(states * m);
+        if (store_parent) parent.resize(states * m);
+        else parent.clear();
+        fill(dp.begin(), dp.begin() + m, INF);
+        for (int v = 0; v < m; ++v) {
+            T* row = &dp[((size_t)1 << v) * m];
+            fill(row, row + m, INF);
+            row[v] = dist[start][node[v]];
+        }
+        if (threads == 1 || m < 2) {
+            // Increasing masks is already a topological order (subsets come first)
+            for (unsigned mask = 1; mask < states; ++mask) {
+                if (mask & (mask - 1)) _pull(mask);
+            }
+            return;
+        }
+        // Layers by popcount of the top 'hb' bits: a block (fixed top bits) is
+        // 2^(m - hb) consecutive rows run in increasing order, clearing a low bit
+        // stays in the block, clearing a top bit lands in the previous layer
+        int hb = min(m, HIGH_BITS), lb = m - hb;
+        ThreadPool pool(threads);
+        vector<vector<int>> C(hb + 1, vector<int>(hb + 1, 0));
+        for (int i = 0; i <= hb; ++i) {
+            C[i][0] = 1;
+            for (int j = 1; j <= i; ++j) C[i][j] = C[i - 1][j - 1] + C[i - 1][j];
+        }
+        for (int k = 0; k <= hb; ++k) {
+            pool.for_each(C[hb][k], 1, [&](int lo, int hi, int) {
+                unsigned top = 0; // lo-th hb-bit mask with k bits (combinatorial number system)
+                for (int b = hb - 1, r = lo, left = k; left > 0; --b) {
+                    if (r >= C[b][left]) { r -= C[b][left]; top |= 1u << b; --left; }
+                }
+                for (int i = lo; i < hi; ++i) {
+                    for (unsigned low = 0; low < (1u << lb); ++low) {
+                        unsigned mask = top << lb | low;
+                        if (mask & (mask - 1)) _pull(mask);
+                    }
+                    if (i + 1 < hi) { // Gosper's hack: next mask with k bits
+                        unsigned c = top & -top, nxt = top + c;
+                        top = (((nxt ^ top) >> 2) / c) | nxt;
                     }
                 }
-            }
+            });
         }
     }
 
+    T _last(int v) const { return dp[(((size_t)1 << m) - 1) * m + v]; }
+
     // Solve Round Trip: Start -> ... -> Start
-    T solve_tour(int start = 0) {
+    T solve_tour(int start = 0, int threads = 1) {
         is_tour = true;
-        _run_dp(start);
+        _run_dp(start, threads);
         T min_cost = INF;
-        int full_mask = (1 << n) - 1;
         int best_last = -1;
-        for (int i = 0; i < n; ++i) {
-            if (i == start) continue;
-            if (dp[full_mask][i] != INF && dist[i][start] != INF) {
-                T current_total = dp[full_mask][i] + dist[i][start];
+        for (int v = 0; v < m; ++v) {
+            int i = node[v];
+            if (_last(v) != INF && dist[i][start] != INF) {
+                T current_total = _last(v) + dist[i][start];
                 if (current_total < min_cost) {
                     min_cost = current_total;
                     best_last = i;
                 }
             }
         }
-        end_node_req = best_last; 
+        end_node_req = best_last;
         return min_cost;
     }
 
     // 2. Solve Hamiltonian Path: Start -> ... -> End
     // Pass end = -1 to allow ending at any node
-    T solve_path(int start = 0, int end = -1) {
+    T solve_path(int start = 0, int end = -1, int threads = 1) {
         is_tour = false;
-        _run_dp(start);
+        _run_dp(start, threads);
 
-        int full_mask = (1 << n) - 1;
-        
+        if (m == 0) { // Single node: the path is just 'start'
+            end_node_req = start;
+            return (end == -1 || end == start) ? 0 : INF;
+        }
         if (end != -1) {
             end_node_req = end;
-            return dp[full_mask][end];
+            return end == start ? INF : _last(idx[end]);
         } else {
             T min_cost = INF;
             int best_end = -1;
-            for (int i = 0; i < n; ++i) {
-                if (dp[full_mask][i] < min_cost) {
-                    min_cost = dp[full_mask][i];
-                    best_end = i;
+            for (int v = 0; v < m; ++v) {
+                if (_last(v) < min_cost) {
+                    min_cost = _last(v);
+                    best_end = node[v];
                 }
             }
             end_node_req = best_end;
@@ -125,14 +269,23 @@ struct TSP {
     vector<int> reconstruct_path() {
         vector<int> path;
         int curr = end_node_req;
-        int mask = (1 << n) - 1;
-        if (curr == -1 || dp[mask][curr] == INF) return {};
-        while (curr != -1) {
-            path.push_back(curr);
-            int prev = parent[mask][curr];
-            mask ^= (1 << curr);
-            curr = prev;
+        if (curr == -1) return {};
+        if (m > 0) {
+            if (curr == start_node || _last(idx[curr]) == INF) return {};
+            unsigned mask = (1u << m) - 1;
+            int v = idx[curr];
+            while (true) {
+                path.push_back(node[v]);
+                unsigned prev = mask ^ (1u << v);
+                if (!prev) break;
+                size_t at = (size_t)mask * m + v;
+                int u = store_parent ? parent[at]
+                                     : _arg(&dp[(size_t)prev * m], &dt[(size_t)v * m], dp[at]);
+                mask = prev;
+                v = u;
+            }
         }
+        path.push_back(start_node);
         reverse(path.begin(), path.end());
         if (is_tour && !path.empty()) {
             path.push_back(start_node);
@@ -150,7 +303,7 @@ void solve() {
     int n, m;
     cin >> n >> m;
 
-    // 1. Initialize (Template param > N)
+    // 1. Initialize (Template param >= N)
     TSP<20> tsp(n);
 
     // 2. Input Graph
@@ -158,7 +311,7 @@ void solve() {
         int u, v; long long w;
         cin >> u >> v >> w;
         // Adjust for 0-indexing if input is 1-based
-        --u; --v; 
+        --u; --v;
         tsp.add_edge(u, v, w, false); // false = undirected
     }
 
@@ -170,11 +323,11 @@ void solve() {
         cout << "-1\n";
     } else {
         cout << ans << "\n";
-        
+
         // 4. Print Path
         vector<int> path = tsp.reconstruct_path();
         for(int x : path) cout << x + 1 << " "; // +1 for 1-based output
         cout << "\n";
     }
 }
-*/
\ No newline at end of file
+*/
@@ -2,12 +2,13 @@
 #define IMPLICIT_SEGTREE_H
 
 #include "template.h"
+#include "monoids.h"
 
 /**
  * Implicit (Dynamic) Segment Tree
  * Handles huge coordinates (up to 10^18) with sparse updates.
  * * USAGE:
- * // 1. Define Range [0, 1e9]
+ * // 1. Define Range [0, 1e9] (Action policy from monoids.h, default: Range Add / Range Sum)
  * ImplicitSegTree<long long> st(0, 1e9);
  * // 2. Range Update & Query
  * st.update(l, r, val);
@@ -15,33 +16,29 @@
  * * MEMORY: O(Q * log(Range))
  * * COMPLEXITY: O(log(Range)) per op
  */
-template<typename T>
+template<typename T, typename Action = RangeAddSum<T>>
 struct ImplicitSegTree {
-    // --- CUSTOMIZE LOGIC ---
-    // Default: Range Add / Range Sum
-    
-    T identity_val = 0;
-    T identity_tag = 0;
-
-    T merge(const T& a, const T& b) {
-        return a + b;
+    using F = typename Action::F;
+
+    // Untouched coordinates hold T() (0); identity_val only answers empty ranges
+    static constexpr T identity_val = Action::e();
+    static constexpr F identity_tag = Action::id();
+
+    static T merge(const T& a, const T& b) {
+        return Action::op(a, b);
     }
 
     // Apply tag to a node covering range [l, r]
-    void apply_tag(T& val, T& tag, T change, long long l, long long r) {
-        val += change * (r - l + 1); // Sum: val += add * len
-        tag += change;               // Add: tag += add
-        
-        // FOR MAX/SET:
-        // val = change; tag = change;
+    static void apply_tag(T& val, F& tag, const F& change, long long l, long long r) {
+        val = Action::mapping(change, val, r - l + 1);
+        tag = Action::composition(change, tag);
     }
-    // -----------------------
 
     struct Node {
         T val;
-        T lazy;
+        F lazy;
         int l = -1, r = -1; // Indices in the pool (-1 = null)
-        Node(T v, T tag) : val(v), lazy(tag) {}
+        Node(T v, F tag) : val(v), lazy(tag) {}
     };
 
     long long min_idx, max_idx;
@@ -54,7 +51,7 @@ struct ImplicitSegTree {
     }
 
     int create_node() {
-        pool.emplace_back(identity_val, identity_tag);
+        pool.emplace_back(T(), identity_tag);
         return pool.size() - 1;
     }
 
@@ -76,11 +73,11 @@ struct ImplicitSegTree {
     }
 
     // Range Update
-    void update(long long ql, long long qr, T val) {
+    void update(long long ql, long long qr, F val) {
         update(0, min_idx, max_idx, ql, qr, val);
     }
 
-    void update(int idx, long long l, long long r, long long ql, long long qr, T val) {
+    void update(int idx, long long l, long long r, long long ql, long long qr, const F& val) {
         if (l > qr || r < ql) return;
         if (l >= ql && r <= qr) {
             apply_tag(pool[idx].val, pool[idx].lazy, val, l, r);
@@ -98,8 +95,8 @@ struct ImplicitSegTree {
         update(pool[idx].r, mid + 1, r, ql, qr, val);
 
         // Pull up
-        T res_l = (pool[idx].l == -1) ? identity_val : pool[pool[idx].l].val;
-        T res_r = (pool[idx].r == -1) ? identity_val : pool[pool[idx].r].val;
+        T res_l = (pool[idx].l == -1) ? T() : pool[pool[idx].l].val;
+        T res_r = (pool[idx].r == -1) ? T() : pool[pool[idx].r].val;
         pool[idx].val = merge(res_l, res_r);
     }
 
@@ -109,7 +106,8 @@ struct ImplicitSegTree {
     }
 
     T query(int idx, long long l, long long r, long long ql, long long qr) {
-        if (l > qr || r < ql || idx == -1) return identity_val;
+        if (l > qr || r < ql) return identity_val;
+        if (idx == -1) return T(); // Untouched range
         if (l >= ql && r <= qr) return pool[idx].val;
 
         push(idx, l, r);
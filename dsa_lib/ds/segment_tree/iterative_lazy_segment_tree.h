@@ -0,0 +1,172 @@
+#ifndef SEGTREE_LAZY_ITERATIVE_H
+#define SEGTREE_LAZY_ITERATIVE_H
+
+#include "template.h"
+#include "monoids.h"
+#include "round_pow2.h"
+
+/**
+ * Iterative (Bottom-Up) Lazy Segment Tree (Range Update / Range Query)
+ * Same API as LazySegTree, no recursion: tags are pushed down only along
+ * the two boundary paths of [l, r]. Value and tag share one Node, so a
+ * node visit touches a single cache line.
+ * * USAGE:
+ * // 1. Define solver (Action policy from monoids.h, default: Range Add / Range Sum)
+ * IterLazySegTree<long long> st(n);
+ * // 2. Updates and Queries
+ * st.update(l, r, val);
+ * cout << st.query(l, r) << "\n";
+ * int idx = st.find_first(l, r, predicate);
+ * * COMPLEXITY: O(log N)
+ * * MEMORY: 2 * Pow2::ceil(N) nodes
+ */
+template<typename T, typename Action = RangeAddSum<T>>
+struct IterLazySegTree {
+    using F = typename Action::F;
+
+    struct Node {
+        T val;
+        F tag;
+    };
+
+    int n, size, log;
+    vector<Node> d;
+
+    // Default Constructor
+    IterLazySegTree() : n(0), size(0), log(0) {}
+
+    // Constructor 1: Size only (all elements = T(), i.e. 0)
+    IterLazySegTree(int _n) : IterLazySegTree(vector<T>(_n)) {}
+
+    // Constructor 2: Initial vector
+    IterLazySegTree(const vector<T>& v) {
+        init(v.size());
+        for (int i = 0; i < n; ++i) d[size + i].val = v[i];
+        for (int i = size - 1; i > 0; --i) pull(i);
+    }
+
+    // Every node at the identity (padding leaves keep it, real leaves are set by the caller)
+    void init(int _n) {
+        n = _n;
+        size = max(1, Pow2::ceil(n));
+        log = __builtin_ctz(size);
+        d.assign(2 * size, Node{Action::e(), Action::id()});
+    }
+
+    // Number of leaves under node k
+    int len(int k) const { return size >> (31 - __builtin_clz(k)); }
+
+    void pull(int k) {
+        d[k].val = Action::op(d[k << 1].val, d[k << 1 | 1].val);
+    }
+
+    void apply_node(int k, const F& f) {
+        d[k].val = Action::mapping(f, d[k].val, len(k));
+        if (k < size) d[k].tag = Action::composition(f, d[k].tag);
+    }
+
+    void push(int k) {
+        if (d[k].tag == Action::id()) return;
+        apply_node(k << 1, d[k].tag);
+        apply_node(k << 1 | 1, d[k].tag);
+        d[k].tag = Action::id();
+    }
+
+    // Push all tags above the boundaries of leaf range [l, r) (already offset by size)
+    void push_bounds(int l, int r) {
+        for (int i = log; i >= 1; --i) {
+            if (((l >> i) << i) != l) push(l >> i);
+            if (((r >> i) << i) != r) push((r - 1) >> i);
+        }
+    }
+
+    // Range Update [l, r] inclusive
+    void update(int l, int r, const F& f) {
+        if (l > r) return;
+        l += size; r += size + 1;
+        push_bounds(l, r);
+        for (int a = l, b = r; a < b; a >>= 1, b >>= 1) {
+            if (a & 1) apply_node(a++, f);
+            if (b & 1) apply_node(--b, f);
+        }
+        for (int i = 1; i <= log; ++i) {
+            if (((l >> i) << i) != l) pull(l >> i);
+            if (((r >> i) << i) != r) pull((r - 1) >> i);
+        }
+    }
+
+    // Range Query [l, r] inclusive
+    T query(int l, int r) {
+        if (l > r) return Action::e();
+        l += size; r += size + 1;
+        push_bounds(l, r);
+        T res_l = Action::e(), res_r = Action::e();
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) res_l = Action::op(res_l, d[l++].val);
+            if (r & 1) res_r = Action::op(d[--r].val, res_r);
+        }
+        return Action::op(res_l, res_r);
+    }
+
+    // TREE WALK: Find first index i in [l, r] where pred(value at i) is true,
+    // pruning nodes whose aggregate fails pred. Returns -1 if not found.
+    template<typename U>
+    int find_first(int l, int r, U pred) {
+        if (l > r) return -1;
+        l += size; r += size + 1;
+        push_bounds(l, r);
+
+        // Covering nodes in left-to-right order ('r' side collected in reverse)
+        int found = -1;
+        vector<int> r_nodes;
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                if (pred(d[l].val)) { found = l; break; }
+                l++;
+            }
+            if (r & 1) r_nodes.push_back(--r);
+        }
+        for (int i = (int)r_nodes.size() - 1; found == -1 && i >= 0; --i) {
+            if (pred(d[r_nodes[i]].val)) found = r_nodes[i];
+        }
+        if (found == -1) return -1;
+
+        // Drill down to the leaf
+        while (found < size) {
+            push(found);
+            found <<= 1;
+            if (!pred(d[found].val)) found++;
+        }
+        return found - size;
+    }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve(){
+    int n, q;
+    cin >> n >> q;
+    vector<ll> a(n);
+    for(auto &x : a) cin >> x;
+
+    // Range Add / Range Max so find_first can prune on the aggregate
+    IterLazySegTree<ll, RangeAddMax<ll>> st(a);
+
+    while(q--) {
+        int type; cin >> type;
+        if (type == 1) { // Range Add
+            int l, r, v; cin >> l >> r >> v;
+            st.update(l-1, r-1, v);
+        } else if (type == 2) { // Range Max
+            int l, r; cin >> l >> r;
+            cout << st.query(l-1, r-1) << "\n";
+        } else if (type == 3) { // First index >= X
+            int l, r; ll x; cin >> l >> r >> x;
+            cout << st.find_first(l-1, r-1, [&](ll val) { return val >= x; }) << "\n";
+        }
+    }
+}
+*/
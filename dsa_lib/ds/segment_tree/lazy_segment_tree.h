@@ -2,12 +2,14 @@
 #define SEGTREE_LAZY_H
 
 #include "template.h"
+#include "monoids.h"
 
 /**
  * Recursive Lazy Segment Tree (Range Update / Range Query)
  * * USAGE:
- * // 1. Define solver
+ * // 1. Define solver (Action policy from monoids.h, default: Range Add / Range Sum)
  * LazySegTree<long long> st(n);
+ * LazySegTree<long long, RangeSetMax<long long>> st2(n);
  * // 2. Updates and Queries
  * st.update(l, r, val); 
  * cout << st.query(l, r) << "\n";
@@ -15,48 +17,40 @@
  * * COMPLEXITY: O(log N)
  * * MEMORY: 4 * N
  */
-template<typename T>
+template<typename T, typename Action = RangeAddSum<T>>
 struct LazySegTree {
-    // --- CUSTOMIZE DATA & TAGS ---
-    // CURRENT: Range Add / Range Sum
-    
-    T identity_val = 0;       // Identity for query (0 for sum, -INF for max)
-    T identity_tag = 0;       // Identity for lazy tag (0 for add, -1 for set)
+    using F = typename Action::F;
+
+    static constexpr T identity_val = Action::e();  // Identity for query
+    static constexpr F identity_tag = Action::id(); // Identity for lazy tag
 
     // Merge two child node values
-    T merge_nodes(const T& a, const T& b) {
-        return a + b;
+    static T merge_nodes(const T& a, const T& b) {
+        return Action::op(a, b);
     }
 
     // Apply a tag to a node
-    // len: range length (needed for Sum, ignore for Max/Min)
-    void apply_tag(T& node_val, T& node_tag, const T& update_val, int len) {
-        node_val += update_val * len; // Sum: val += add * len
-        node_tag += update_val;       // Add: tag += add
-        
-        // FOR RANGE SET / RANGE MAX:
-        // node_val = update_val;
-        // node_tag = update_val;
+    // len: range length (needed for Sum, ignored for Max/Min)
+    static void apply_tag(T& node_val, F& node_tag, const F& update_val, int len) {
+        node_val = Action::mapping(update_val, node_val, len);
+        node_tag = Action::composition(update_val, node_tag);
     }
-    // -----------------------------
 
     int n;
-    vector<T> tree, lazy;
+    vector<T> tree;
+    vector<F> lazy;
 
     // Default Constructor
     LazySegTree() : n(0) {}
 
-    // Constructor 1: Size only
-    LazySegTree(int _n) : n(_n) {
-        tree.assign(4 * n, identity_val);
-        lazy.assign(4 * n, identity_tag);
-    }
+    // Constructor 1: Size only (all elements = T(), i.e. 0)
+    LazySegTree(int _n) : LazySegTree(vector<T>(_n)) {}
 
     // Constructor 2: Initial vector
     LazySegTree(const vector<T>& v) : n(v.size()) {
         tree.assign(4 * n, identity_val);
         lazy.assign(4 * n, identity_tag);
-        build(v, 1, 0, n - 1);
+        if (n > 0) build(v, 1, 0, n - 1);
     }
 
     void push(int node, int start, int end) {
@@ -79,11 +73,11 @@ struct LazySegTree {
     }
 
     // Range Update [l, r] inclusive
-    void update(int l, int r, T val) {
+    void update(int l, int r, F val) {
         update(1, 0, n - 1, l, r, val);
     }
 
-    void update(int node, int start, int end, int l, int r, T val) {
+    void update(int node, int start, int end, int l, int r, const F& val) {
         if (l > end || r < start) return;
         if (l <= start && end <= r) {
             apply_tag(tree[node], lazy[node], val, end - start + 1);
@@ -151,6 +145,7 @@ void solve(){
 
     // CASE B: Build empty (0s)
     LazySegTree<ll> st(n); 
+    // Other policies: RangeAddMin, RangeAffineSum (update with {a, b}), RangeSetSum, ...
 
     while(q--) {
         int type; cin >> type;
@@ -163,7 +158,7 @@ void solve(){
         } else if (type == 3) { // Find First >= X
             int l, r, x; cin >> l >> r >> x;
             auto pred = [&](ll val) { return val >= x; };
-            // Note: For find_first to work reliably, tree usually needs to be Max/Min
+            // Note: For find_first to work reliably, use a Max/Min policy (e.g. RangeAddMax)
             cout << st.find_first(l-1, r-1, pred) << "\n";
         }
     }
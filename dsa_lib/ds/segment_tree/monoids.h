@@ -0,0 +1,115 @@
+#ifndef SEGTREE_MONOIDS_H
+#define SEGTREE_MONOIDS_H
+
+#include "template.h"
+
+/**
+ * Monoid & Lazy Action Policies for the Segment Trees
+ * * USAGE:
+ * SegTree<ll, MinMonoid<ll>> st(a);              // point update / range min
+ * LazySegTree<ll, RangeAffineSum<ll>> lst(a);    // range x -> a*x+b / range sum
+ * lst.update(l, r, {2, 3});
+ * * MONOID interface (SegTree, PersistentSegTree):
+ * static constexpr T e();                   // identity
+ * static T op(const T& a, const T& b);      // associative merge
+ * * ACTION interface (LazySegTree, ImplicitSegTree) = MONOID plus:
+ * using F;                                  // tag type
+ * static constexpr F id();                  // "no update" tag
+ * static T mapping(const F& f, const T& x, long long len); // apply f to a node of 'len' elements
+ * static F composition(const F& f, const F& g);            // f after g
+ * static constexpr bool commutative = true;  // OPTIONAL: f after g == g after f
+ *                                            // (lets PersistentLazySegTree keep tags in place)
+ * * Write your own struct with the same members for custom workloads.
+ */
+
+// --- Monoids ---
+
+template<typename T>
+struct SumMonoid {
+    static constexpr T e() { return T(0); }
+    static T op(const T& a, const T& b) { return a + b; }
+};
+
+template<typename T>
+struct MinMonoid {
+    static constexpr T e() { return numeric_limits<T>::max(); }
+    static T op(const T& a, const T& b) { return min(a, b); }
+};
+
+template<typename T>
+struct MaxMonoid {
+    static constexpr T e() { return numeric_limits<T>::lowest(); }
+    static T op(const T& a, const T& b) { return max(a, b); }
+};
+
+// --- Lazy Actions ---
+// Trees built from a size start every element at T() (0), never at the identity:
+// Min/Max mappings leave the identity untouched so padding nodes never overflow.
+
+// Range Add / Range Sum
+template<typename T>
+struct RangeAddSum : SumMonoid<T> {
+    using F = T;
+    static constexpr bool commutative = true;
+    static constexpr F id() { return F(0); }
+    static T mapping(const F& f, const T& x, long long len) { return x + f * len; }
+    static F composition(const F& f, const F& g) { return f + g; }
+};
+
+// Range Add / Range Min
+template<typename T>
+struct RangeAddMin : MinMonoid<T> {
+    using F = T;
+    static constexpr bool commutative = true;
+    static constexpr F id() { return F(0); }
+    static T mapping(const F& f, const T& x, long long) { return x == MinMonoid<T>::e() ? x : x + f; }
+    static F composition(const F& f, const F& g) { return f + g; }
+};
+
+// Range Add / Range Max
+template<typename T>
+struct RangeAddMax : MaxMonoid<T> {
+    using F = T;
+    static constexpr bool commutative = true;
+    static constexpr F id() { return F(0); }
+    static T mapping(const F& f, const T& x, long long) { return x == MaxMonoid<T>::e() ? x : x + f; }
+    static F composition(const F& f, const F& g) { return f + g; }
+};
+
+// Range Affine (x -> a*x + b, tag = {a, b}) / Range Sum
+template<typename T>
+struct RangeAffineSum : SumMonoid<T> {
+    using F = pair<T, T>;
+    static constexpr F id() { return {T(1), T(0)}; }
+    static T mapping(const F& f, const T& x, long long len) { return f.first * x + f.second * len; }
+    static F composition(const F& f, const F& g) { return {f.first * g.first, f.first * g.second + f.second}; }
+};
+
+// Range Set / Range Sum (numeric_limits<T>::min() is reserved as "no assignment")
+template<typename T>
+struct RangeSetSum : SumMonoid<T> {
+    using F = T;
+    static constexpr F id() { return numeric_limits<T>::min(); }
+    static T mapping(const F& f, const T& x, long long len) { return f == id() ? x : f * len; }
+    static F composition(const F& f, const F& g) { return f == id() ? g : f; }
+};
+
+// Range Set / Range Min
+template<typename T>
+struct RangeSetMin : MinMonoid<T> {
+    using F = T;
+    static constexpr F id() { return numeric_limits<T>::min(); }
+    static T mapping(const F& f, const T& x, long long) { return f == id() ? x : f; }
+    static F composition(const F& f, const F& g) { return f == id() ? g : f; }
+};
+
+// Range Set / Range Max
+template<typename T>
+struct RangeSetMax : MaxMonoid<T> {
+    using F = T;
+    static constexpr F id() { return numeric_limits<T>::min(); }
+    static T mapping(const F& f, const T& x, long long) { return f == id() ? x : f; }
+    static F composition(const F& f, const F& g) { return f == id() ? g : f; }
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef PERSISTENT_LAZY_SEGTREE_H
+#define PERSISTENT_LAZY_SEGTREE_H
+
+#include "template.h"
+#include "monoids.h"
+
+/**
+ * Persistent Lazy Segment Tree (Range Update / Range Query over versions)
+ * * USAGE:
+ * // 1. Build initial version (root 0), Action policy from monoids.h (default: Range Add / Range Sum)
+ * PersistentLazySegTree<long long> pst(initial_vector);
+ * // 2. Range update creates NEW version
+ * int root_v2 = pst.range_update(pst.roots[0], l, r, val);
+ * pst.roots.push_back(root_v2);
+ * // 3. Query any version (never allocates)
+ * cout << pst.query(root_v2, l, r) << "\n";
+ * * UPDATES copy the two boundary paths; a pending tag is pushed into fresh
+ *   copies of the children on the way down, old versions stay untouched.
+ *   Actions marked 'commutative' (range add) skip the push: tags stay on
+ *   their node for good ("mark permanence"), so only the paths are copied.
+ * * QUERIES push nothing: ancestor tags are composed on the way down and
+ *   applied to the covering nodes (no allocation on reads).
+ * * COMPLEXITY: O(log N) per op
+ * * MEMORY: O(N + Q log N), at most 4 (2 if commutative) new nodes per level per update
+ */
+
+// Detects the optional 'commutative' flag of an Action
+template<typename A, typename = void>
+struct is_commutative_action : false_type {};
+template<typename A>
+struct is_commutative_action<A, void_t<decltype(A::commutative)>> : bool_constant<A::commutative> {};
+
+template<typename T, typename Action = RangeAddSum<T>>
+struct PersistentLazySegTree {
+    using F = typename Action::F;
+    static constexpr bool PERMANENT = is_commutative_action<Action>::value;
+
+    struct Node {
+        T val;   // Aggregate of the range, including this node's own tag
+        F tag;   // Pending for the children (kept forever if PERMANENT)
+        int l, r;
+    };
+
+    int n;
+    vector<Node> pool;
+    vector<int> roots; // Stores root index of each version
+
+    PersistentLazySegTree(const vector<T>& v) : n(v.size()) {
+        pool.reserve(n * 2 + 200000); // Pre-allocate some space
+        roots.push_back(build(v, 0, n - 1));
+    }
+
+    int new_node(const T& val, const F& tag, int l, int r) {
+        pool.push_back({val, tag, l, r});
+        return pool.size() - 1;
+    }
+
+    // Copy of 'node' with 'f' applied on top
+    int apply_copy(int node, const F& f, long long len) {
+        Node nd = pool[node];
+        return new_node(Action::mapping(f, nd.val, len), Action::composition(f, nd.tag), nd.l, nd.r);
+    }
+
+    int build(const vector<T>& v, int l, int r) {
+        if (l == r) return new_node(v[l], Action::id(), -1, -1);
+        int mid = l + (r - l) / 2;
+        int a = build(v, l, mid), b = build(v, mid + 1, r);
+        return new_node(Action::op(pool[a].val, pool[b].val), Action::id(), a, b);
+    }
+
+    // Range Update [ql, qr]: Returns NEW root index
+    int range_update(int prev_root, int ql, int qr, const F& f) {
+        return range_update(prev_root, 0, n - 1, ql, qr, f, Action::id());
+    }
+
+    // 'pend' is the parent's tag that still has to reach this node
+    int range_update(int node, int l, int r, int ql, int qr, const F& f, const F& pend) {
+        bool has_pend = !(pend == Action::id());
+        if (qr < l || r < ql) return has_pend ? apply_copy(node, pend, r - l + 1) : node;
+        if (ql <= l && r <= qr) return apply_copy(node, Action::composition(f, pend), r - l + 1);
+
+        Node nd = pool[node];
+        int mid = l + (r - l) / 2;
+        if (PERMANENT) {
+            // pend is always id here: the tag stays and is re-applied on pull
+            int a = range_update(nd.l, l, mid, ql, qr, f, pend);
+            int b = range_update(nd.r, mid + 1, r, ql, qr, f, pend);
+            T val = Action::mapping(nd.tag, Action::op(pool[a].val, pool[b].val), r - l + 1);
+            return new_node(val, nd.tag, a, b);
+        }
+        F down = Action::composition(pend, nd.tag);
+        int a = range_update(nd.l, l, mid, ql, qr, f, down);
+        int b = range_update(nd.r, mid + 1, r, ql, qr, f, down);
+        return new_node(Action::op(pool[a].val, pool[b].val), Action::id(), a, b);
+    }
+
+    // Range Query on specific version
+    T query(int root, int ql, int qr) const {
+        return query(root, 0, n - 1, ql, qr, Action::id());
+    }
+
+    // 'acc' = composition of all ancestor tags (outermost applied last)
+    T query(int node, int l, int r, int ql, int qr, const F& acc) const {
+        if (qr < l || r < ql) return Action::e();
+        const Node& nd = pool[node];
+        if (ql <= l && r <= qr) return Action::mapping(acc, nd.val, r - l + 1);
+        F down = Action::composition(acc, nd.tag);
+        int mid = l + (r - l) / 2;
+        return Action::op(query(nd.l, l, mid, ql, qr, down),
+                          query(nd.r, mid + 1, r, ql, qr, down));
+    }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve() {
+    int n, q;
+    cin >> n >> q;
+    vector<long long> a(n);
+    for(auto& x : a) cin >> x;
+
+    // 1. Build Version 0 (Range Add / Range Sum)
+    PersistentLazySegTree<long long> pst(a);
+
+    while(q--) {
+        int type; cin >> type;
+        if (type == 1) { // Range add on version k -> new version
+            int k, l, r; long long x; cin >> k >> l >> r >> x;
+            pst.roots.push_back(pst.range_update(pst.roots[k], l - 1, r - 1, x));
+        } else { // Range sum on version k
+            int k, l, r; cin >> k >> l >> r;
+            cout << pst.query(pst.roots[k], l - 1, r - 1) << "\n";
+        }
+    }
+}
+*/
@@ -2,11 +2,12 @@
 #define PERSISTENT_SEGTREE_H
 
 #include "template.h"
+#include "monoids.h"
 
 /**
  * Persistent Segment Tree
  * * USAGE:
- * // 1. Build initial version (root 0)
+ * // 1. Build initial version (root 0), Monoid policy from monoids.h (default: Sum)
  * PersistentSegTree<long long> pst(initial_vector);
  * // 2. Update creates NEW version
  * int root_v1 = pst.roots[0];
@@ -14,20 +15,23 @@
  * // 3. Query any version
  * cout << pst.query(root_v1, l, r) << "\n";
  * cout << pst.query(root_v2, l, r) << "\n";
- * * COMPLEXITY: O(log N) per op
- * * MEMORY: O(N + Q log N)
+ * // 4. (Optional) Relayout before a read-heavy phase
+ * pst.compact(hot_versions);
+ * // 5. (Optional) Bounded memory: keep only the last K versions
+ * pst.set_retention(K);
+ * int ver = pst.add_version(pst.update(pst.roots[ver], pos, val));
+ * pst.drop_version(k);   // retire a single version
+ * auto st = pst.mem_stats();
+ * * COMPLEXITY: O(log N) per op, amortized O(log N) per add_version with GC
+ * * MEMORY: O(N + Q log N), O(N + K log N) with retention
  */
-template<typename T>
+template<typename T, typename Monoid = SumMonoid<T>>
 struct PersistentSegTree {
-    // --- CUSTOMIZE LOGIC ---
-    // Default: Point Update / Range Sum
-    
-    T identity_val = 0;
+    static constexpr T identity_val = Monoid::e();
 
-    T merge(const T& a, const T& b) {
-        return a + b;
+    static T merge(const T& a, const T& b) {
+        return Monoid::op(a, b);
     }
-    // -----------------------
 
     struct Node {
         T val;
@@ -36,7 +40,13 @@ struct PersistentSegTree {
 
     int n;
     vector<Node> pool;
-    vector<int> roots; // Stores root index of each version
+    vector<int> roots; // Stores root index of each version (-1 = dropped)
+
+    // --- Version retirement / GC state ---
+    int retain_last = 0;     // Keep only the last K versions (0 = keep all)
+    int first_live = 0;      // Versions before this were retired by the policy
+    int dropped = 0;         // Versions dropped since the last collect()
+    size_t gc_threshold = 0; // Pool size that allows the next automatic collect()
 
     PersistentSegTree(const vector<T>& v) : n(v.size()) {
         pool.reserve(n * 4 + 200000); // Pre-allocate some space
@@ -122,6 +132,118 @@ struct PersistentSegTree {
                              mid + 1, val_r, k - count_left);
         }
     }
+
+    /**
+     * Compact / Freeze: relayout 'pool' for read-heavy phases.
+     * Nodes of the versions in 'hot' (indices into roots, default: all) are
+     * placed first in van Emde Boas order, then the remaining versions; nodes
+     * unreachable from 'roots' are dropped. Every entry of 'roots' is rewritten,
+     * node indices kept anywhere else become invalid.
+     * * COMPLEXITY: O(P log log N) for P reachable nodes
+     */
+    void compact(vector<int> hot = {}) {
+        if (hot.empty()) {
+            hot.resize(roots.size());
+            iota(hot.begin(), hot.end(), 0);
+        }
+        vector<char> is_hot(roots.size(), 0);
+        for (int v : hot) is_hot[v] = 1;
+        for (int v = 0; v < (int)roots.size(); ++v)
+            if (!is_hot[v]) hot.push_back(v);
+
+        int height = 1;
+        while ((1 << (height - 1)) < n) ++height;
+
+        vector<int> new_id(pool.size(), -1), stamp(pool.size(), -1);
+        vector<Node> out;
+        out.reserve(pool.size());
+        for (int pass = 0; pass < (int)hot.size(); ++pass) {
+            veb_layout(roots[hot[pass]], height, pass, new_id, stamp, out);
+        }
+        for (Node& nd : out) {
+            if (nd.l != -1) nd.l = new_id[nd.l];
+            if (nd.r != -1) nd.r = new_id[nd.r];
+        }
+        for (int& rt : roots)
+            if (rt != -1) rt = new_id[rt];
+        pool.swap(out);
+    }
+
+    // --- Version Retirement & Garbage Collection ---
+
+    struct MemStats {
+        size_t nodes;         // Nodes in pool (live + garbage)
+        size_t node_capacity; // Allocated node slots
+        size_t bytes;         // Heap bytes held by pool and roots
+        int live_versions;
+    };
+
+    MemStats mem_stats() const {
+        int live = count_if(roots.begin(), roots.end(), [](int rt) { return rt != -1; });
+        return {pool.size(), pool.capacity(),
+                pool.capacity() * sizeof(Node) + roots.capacity() * sizeof(int), live};
+    }
+
+    // Retention policy: add_version() retires everything but the last k versions
+    void set_retention(int k) {
+        retain_last = k;
+    }
+
+    // Marks version k as dead; its nodes are reclaimed by the next collect()
+    void drop_version(int k) {
+        if (roots[k] == -1) return;
+        roots[k] = -1;
+        dropped++;
+    }
+
+    // Registers 'root' as a new version and returns its index.
+    // Applies the retention policy and collects garbage once the pool has doubled
+    // since the last collection, so node indices not stored in 'roots' are invalidated here.
+    int add_version(int root) {
+        roots.push_back(root);
+        if (retain_last > 0) {
+            while ((int)roots.size() - first_live > retain_last) drop_version(first_live++);
+        }
+        if (dropped > 0 && pool.size() >= gc_threshold) collect();
+        return roots.size() - 1;
+    }
+
+    // Mark-and-compact: keeps only nodes reachable from live roots, releases the rest
+    void collect() {
+        compact();
+        pool.shrink_to_fit();
+        gc_threshold = 2 * pool.size();
+        dropped = 0;
+    }
+
+    // Places the not yet placed part of the subtree of 'v', limited to 'h' levels:
+    // top h/2 levels first, then each subtree hanging below them.
+    // Versions only share whole subtrees, so nodes placed by an earlier pass are complete.
+    void veb_layout(int v, int h, int pass, vector<int>& new_id, vector<int>& stamp, vector<Node>& out) {
+        if (v == -1 || new_id[v] != -1) return;
+        if (h == 1) {
+            new_id[v] = out.size();
+            stamp[v] = pass;
+            out.push_back(pool[v]);
+            return;
+        }
+        int top = h / 2;
+        veb_layout(v, top, pass, new_id, stamp, out);
+
+        vector<int> frontier;
+        auto collect = [&](auto&& self, int u, int d) -> void {
+            if (u == -1) return;
+            if (d == top) {
+                if (new_id[u] == -1) frontier.push_back(u);
+                return;
+            }
+            if (stamp[u] != pass) return;
+            self(self, pool[u].l, d + 1);
+            self(self, pool[u].r, d + 1);
+        };
+        collect(collect, v, 0);
+        for (int u : frontier) veb_layout(u, h - top, pass, new_id, stamp, out);
+    }
 };
 
 #endif
@@ -145,6 +267,7 @@ void solve() {
             // Create version (last_version + 1) based on version 'k'
             int new_root = pst.update(pst.roots[k], pos - 1, val);
             pst.roots.push_back(new_root);
+            // With a retention policy use pst.add_version(new_root) instead
         } else { // Query
             int k, l, r; cin >> k >> l >> r;
             cout << pst.query(pst.roots[k], l - 1, r - 1) << "\n";
@@ -2,43 +2,48 @@
 #define SEGTREE_ITERATIVE_H
 
 #include "template.h"
+#include "monoids.h"
 
 /**
  * Iterative Segment Tree (Point Update / Range Query)
  * * USAGE:
- * // 1. Define solver
- * SegTree<long long> st(n);
+ * // 1. Define solver (Monoid policy from monoids.h, default: Max)
+ * SegTree<long long, SumMonoid<long long>> st(n);      // n zeros
+ * SegTree<long long> st2(n, -1e18);                     // n copies of -1e18
+ * // NOTE: the query identity comes from Monoid::e(); the old trailing
+ * // 'identity' argument of SegTree(v, identity) is gone, and the second
+ * // argument of SegTree(n, x) is now the initial value of every element
  * // 2. Update and Query
  * st.update(pos, val);
  * long long sum = st.query(l, r);
  * // 3. Binary Search on Tree (Find first index in [l,r] satisfying pred)
  * int idx = st.find_first(l, r, [&](long long x){ return x >= 10; });
+ * // 4. Offline batches (many queries / point updates in one pass)
+ * st.query_batch(ranges, answers);
+ * st.update_batch(sorted_updates);
  * * COMPLEXITY: O(log N) ops, O(N) memory
  */
-template<typename T>
+template<typename T, typename Monoid = MaxMonoid<T>>
 struct SegTree {
     int n;
     vector<T> tree;
-    T identity_element;
+    static constexpr T identity_element = Monoid::e();
 
-    // --- CUSTOMIZE MERGE LOGIC ---
-    // Example: Range Max
-    // Change merge() to max(a,b) and identity_element to -INF
-    T merge(const T& a, const T& b) {
-        return max(a, b); 
+    static T merge(const T& a, const T& b) {
+        return Monoid::op(a, b);
     }
-    // -----------------------------
 
     // Default Constructor
-    SegTree() : n(0), identity_element(0) {}
+    SegTree() : n(0) {}
 
-    // Constructor 1: Size and Identity
-    SegTree(int _n, T identity = 0) : n(_n), identity_element(identity) {
-        tree.assign(2 * n, identity_element);
+    // Constructor 1: Size (all elements = init, 0 by default)
+    SegTree(int _n, T init = T()) : n(_n) {
+        tree.assign(2 * n, init);
+        for (int i = n - 1; i > 0; --i) tree[i] = merge(tree[i << 1], tree[i << 1 | 1]);
     }
 
     // Constructor 2: From vector
-    SegTree(const vector<T>& v, T identity = 0) : n(v.size()), identity_element(identity) {
+    SegTree(const vector<T>& v) : n(v.size()) {
         tree.assign(2 * n, identity_element);
         for (int i = 0; i < n; ++i) tree[n + i] = v[i];
         for (int i = n - 1; i > 0; --i) tree[i] = merge(tree[i << 1], tree[i << 1 | 1]);
@@ -69,6 +74,52 @@ struct SegTree {
         return merge(res_l, res_r);
     }
 
+    /**
+     * Batched Range Query
+     * Answers out[i] = query(qs[i].first, qs[i].second) (inclusive).
+     * While answering query i, prefetches the lowest LEVELS ancestors of the
+     * boundaries of query i + AHEAD (the levels that miss cache on big trees).
+     */
+    void query_batch(const vector<pair<int, int>>& qs, vector<T>& out) {
+        const size_t AHEAD = 8;
+        const int LEVELS = 8;
+        out.resize(qs.size());
+        for (size_t i = 0; i < qs.size(); ++i) {
+            if (i + AHEAD < qs.size()) {
+                int l = qs[i + AHEAD].first + n, r = qs[i + AHEAD].second + n;
+                for (int k = 0; k < LEVELS; ++k) {
+                    __builtin_prefetch(&tree[l >> k]);
+                    __builtin_prefetch(&tree[r >> k]);
+                }
+            }
+            out[i] = query(qs[i].first, qs[i].second);
+        }
+    }
+
+    /**
+     * Batched Point Update
+     * Sets a[pos] = val for every {pos, val} (REQUIRES: sorted by pos).
+     * Rebuilds each affected internal node once per level instead of once per update.
+     */
+    void update_batch(const vector<pair<int, T>>& ups) {
+        vector<int> cur;
+        cur.reserve(ups.size());
+        for (const auto& u : ups) {
+            int pos = u.first + n;
+            tree[pos] = u.second;
+            if (pos > 1 && (cur.empty() || cur.back() != pos >> 1)) cur.push_back(pos >> 1);
+        }
+        // Shifting a sorted list keeps it sorted, so dedup only compares neighbours
+        while (!cur.empty()) {
+            int m = 0;
+            for (int p : cur) {
+                tree[p] = merge(tree[p << 1], tree[p << 1 | 1]);
+                if (p > 1 && (m == 0 || cur[m - 1] != p >> 1)) cur[m++] = p >> 1;
+            }
+            cur.resize(m);
+        }
+    }
+
     /**
      * O(log N) Tree Search
      * Finds the first index 'i' in [l, r] such that 'pred(tree[i])' is true.
@@ -150,8 +201,8 @@ void solve() {
     vector<ll> a(n);
     for(auto& x : a) cin >> x;
     
-    // Note: Ensure 'merge' is max(a,b) and identity is -INF inside struct
-    SegTree<ll> st(a, -1e18); 
+    // Other policies: SumMonoid<ll>, MinMonoid<ll> or your own {e(), op()}
+    SegTree<ll, MaxMonoid<ll>> st(a); 
 
     while(q--) {
         int type; cin >> type;
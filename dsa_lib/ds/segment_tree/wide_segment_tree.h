@@ -0,0 +1,244 @@
+#ifndef SEGTREE_WIDE_H
+#define SEGTREE_WIDE_H
+
+#include "template.h"
+#include "monoids.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * Wide (B-ary) Segment Tree (Point Update / Range Query)
+ * Drop-in for SegTree: same query / update / add / find_first API.
+ * Every node has B children stored contiguously (B = 64 / sizeof(T), one
+ * cache line), so a query touches log_B(N) lines instead of log_2(N).
+ * In-block reductions for Sum/Min/Max over int / long long use AVX2
+ * when compiled with -mavx2 (or -march=native), scalar loops otherwise.
+ * * USAGE:
+ * WideSegTree<long long, SumMonoid<long long>> st(a);
+ * st.update(pos, val);
+ * long long s = st.query(l, r);
+ * int idx = st.find_first(l, r, [&](long long x){ return x >= 10; });
+ * * COMPLEXITY: O(B * log_B N) update, O(log_B N) query, O(N) memory
+ */
+
+// Reduction of lanes [a, b] of one block of B values (generic scalar version)
+template<typename Monoid, typename T, int B>
+struct WideReduce {
+    static T run(const T* p, int a, int b) {
+        T res = Monoid::e();
+        for (int i = a; i <= b; ++i) res = Monoid::op(res, p[i]);
+        return res;
+    }
+};
+
+#ifdef __AVX2__
+// 8 x int64 block: lanes outside [a, b] are replaced by 'id' before the tree reduction
+template<typename VOp>
+inline long long wide_reduce_i64(const long long* p, int a, int b, long long id, VOp vop) {
+    const __m256i lo = _mm256_set_epi64x(3, 2, 1, 0), hi = _mm256_set_epi64x(7, 6, 5, 4);
+    const __m256i va = _mm256_set1_epi64x(a - 1), vb = _mm256_set1_epi64x(b + 1);
+    const __m256i vid = _mm256_set1_epi64x(id);
+    __m256i x0 = _mm256_loadu_si256((const __m256i*)p);
+    __m256i x1 = _mm256_loadu_si256((const __m256i*)(p + 4));
+    __m256i m0 = _mm256_and_si256(_mm256_cmpgt_epi64(lo, va), _mm256_cmpgt_epi64(vb, lo));
+    __m256i m1 = _mm256_and_si256(_mm256_cmpgt_epi64(hi, va), _mm256_cmpgt_epi64(vb, hi));
+    __m256i v = vop(_mm256_blendv_epi8(vid, x0, m0), _mm256_blendv_epi8(vid, x1, m1));
+    v = vop(v, _mm256_permute4x64_epi64(v, 0x4E));
+    v = vop(v, _mm256_shuffle_epi32(v, 0x4E));
+    return _mm256_extract_epi64(v, 0);
+}
+
+// 16 x int32 block
+template<typename VOp>
+inline int wide_reduce_i32(const int* p, int a, int b, int id, VOp vop) {
+    const __m256i lo = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i hi = _mm256_set_epi32(15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i va = _mm256_set1_epi32(a - 1), vb = _mm256_set1_epi32(b + 1);
+    const __m256i vid = _mm256_set1_epi32(id);
+    __m256i x0 = _mm256_loadu_si256((const __m256i*)p);
+    __m256i x1 = _mm256_loadu_si256((const __m256i*)(p + 8));
+    __m256i m0 = _mm256_and_si256(_mm256_cmpgt_epi32(lo, va), _mm256_cmpgt_epi32(vb, lo));
+    __m256i m1 = _mm256_and_si256(_mm256_cmpgt_epi32(hi, va), _mm256_cmpgt_epi32(vb, hi));
+    __m256i v = vop(_mm256_blendv_epi8(vid, x0, m0), _mm256_blendv_epi8(vid, x1, m1));
+    v = vop(v, _mm256_permute4x64_epi64(v, 0x4E));
+    v = vop(v, _mm256_shuffle_epi32(v, 0x4E));
+    v = vop(v, _mm256_shuffle_epi32(v, 0xB1));
+    return _mm256_extract_epi32(v, 0);
+}
+
+template<> struct WideReduce<SumMonoid<long long>, long long, 8> {
+    static long long run(const long long* p, int a, int b) {
+        return wide_reduce_i64(p, a, b, 0, [](__m256i x, __m256i y) { return _mm256_add_epi64(x, y); });
+    }
+};
+template<> struct WideReduce<MinMonoid<long long>, long long, 8> {
+    static long long run(const long long* p, int a, int b) {
+        return wide_reduce_i64(p, a, b, MinMonoid<long long>::e(), [](__m256i x, __m256i y) {
+            return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(x, y));
+        });
+    }
+};
+template<> struct WideReduce<MaxMonoid<long long>, long long, 8> {
+    static long long run(const long long* p, int a, int b) {
+        return wide_reduce_i64(p, a, b, MaxMonoid<long long>::e(), [](__m256i x, __m256i y) {
+            return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(y, x));
+        });
+    }
+};
+template<> struct WideReduce<SumMonoid<int>, int, 16> {
+    static int run(const int* p, int a, int b) {
+        return wide_reduce_i32(p, a, b, 0, [](__m256i x, __m256i y) { return _mm256_add_epi32(x, y); });
+    }
+};
+template<> struct WideReduce<MinMonoid<int>, int, 16> {
+    static int run(const int* p, int a, int b) {
+        return wide_reduce_i32(p, a, b, MinMonoid<int>::e(), [](__m256i x, __m256i y) { return _mm256_min_epi32(x, y); });
+    }
+};
+template<> struct WideReduce<MaxMonoid<int>, int, 16> {
+    static int run(const int* p, int a, int b) {
+        return wide_reduce_i32(p, a, b, MaxMonoid<int>::e(), [](__m256i x, __m256i y) { return _mm256_max_epi32(x, y); });
+    }
+};
+#endif
+
+template<typename T, typename Monoid = MaxMonoid<T>, int B = (sizeof(T) >= 32 ? 2 : 64 / (int)sizeof(T))>
+struct WideSegTree {
+    static constexpr T identity_element = Monoid::e();
+    using Reduce = WideReduce<Monoid, T, B>;
+
+    int n;
+    // levels[0] = leaves, levels[k + 1][j] = aggregate of levels[k][j*B .. j*B + B - 1]
+    // Each level is padded with identity to a multiple of B; the last level is one block.
+    vector<vector<T>> levels;
+
+    static T merge(const T& a, const T& b) {
+        return Monoid::op(a, b);
+    }
+
+    // Default Constructor
+    WideSegTree() : n(0) {}
+
+    // Constructor 1: Size (all elements = init, 0 by default, as SegTree)
+    WideSegTree(int _n, T init_val = T()) : WideSegTree(vector<T>(_n, init_val)) {}
+
+    // Constructor 2: From vector
+    WideSegTree(const vector<T>& v) : n(v.size()) {
+        init();
+        copy(v.begin(), v.end(), levels[0].begin());
+        for (size_t k = 1; k < levels.size(); ++k) {
+            const T* child = levels[k - 1].data();
+            int m = levels[k - 1].size() / B;
+            for (int j = 0; j < m; ++j) levels[k][j] = Reduce::run(child + j * B, 0, B - 1);
+        }
+    }
+
+    void init() {
+        levels.clear();
+        int sz = max(1, (n + B - 1) / B) * B;
+        levels.emplace_back(sz, identity_element);
+        while (sz > B) {
+            sz = (sz / B + B - 1) / B * B;
+            levels.emplace_back(sz, identity_element);
+        }
+    }
+
+    // Point Update: set val at pos (0-indexed)
+    void update(int pos, T val) {
+        levels[0][pos] = val;
+        for (size_t k = 1; k < levels.size(); ++k) {
+            pos /= B;
+            levels[k][pos] = Reduce::run(levels[k - 1].data() + pos * B, 0, B - 1);
+        }
+    }
+
+    // Helper: Add val to existing pos
+    void add(int pos, T val) {
+        update(pos, levels[0][pos] + val);
+    }
+
+    // Range Query [l, r] inclusive
+    T query(int l, int r) const {
+        T res_l = identity_element, res_r = identity_element;
+        for (size_t k = 0; l <= r; ++k) {
+            const T* p = levels[k].data();
+            int lb = l / B, rb = r / B;
+            if (lb == rb) {
+                res_l = merge(res_l, Reduce::run(p + lb * B, l - lb * B, r - lb * B));
+                break;
+            }
+            res_l = merge(res_l, Reduce::run(p + lb * B, l - lb * B, B - 1));
+            res_r = merge(Reduce::run(p + rb * B, 0, r - rb * B), res_r);
+            l = lb + 1; r = rb - 1;
+        }
+        return merge(res_l, res_r);
+    }
+
+    /**
+     * O(B * log_B N) Tree Search
+     * Finds the first index 'i' in [l, r] such that 'pred(value)' is true,
+     * pruning nodes whose aggregate fails pred. Returns -1 if not found.
+     */
+    template<typename U>
+    int find_first(int l, int r, U pred) const {
+        // Covering pieces {level, first index, last index}; 'r' side collected in reverse
+        array<int, 3> left[32], right[32];
+        int nl = 0, nr = 0;
+        for (int k = 0; l <= r; ++k) {
+            int lb = l / B, rb = r / B;
+            if (lb == rb) { left[nl++] = {k, l, r}; break; }
+            left[nl++] = {k, l, lb * B + B - 1};
+            right[nr++] = {k, rb * B, r};
+            l = lb + 1; r = rb - 1;
+        }
+        while (nr > 0) left[nl++] = right[--nr];
+
+        for (int t = 0; t < nl; ++t) {
+            int k = left[t][0];
+            for (int i = left[t][1]; i <= left[t][2]; ++i) {
+                if (!pred(levels[k][i])) continue;
+                // Drill down to the leaf (no matching child: pred is not monotone)
+                for (; k > 0; --k) {
+                    int c = i * B, end = i * B + B;
+                    while (c < end && !pred(levels[k - 1][c])) ++c;
+                    if (c == end) return -1;
+                    i = c;
+                }
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+#endif
+
+/*
+Usage Example:
+
+void solve() {
+    int n, q;
+    cin >> n >> q;
+    vector<ll> a(n);
+    for(auto& x : a) cin >> x;
+
+    // Same calls as SegTree; compile with -march=native for the AVX2 reductions
+    WideSegTree<ll, MaxMonoid<ll>> st(a);
+
+    while(q--) {
+        int type; cin >> type;
+        if (type == 1) { // Update
+            int pos, v; cin >> pos >> v;
+            st.update(pos-1, v);
+        } else if (type == 2) { // Query Max
+            int l, r; cin >> l >> r;
+            cout << st.query(l-1, r-1) << "\n";
+        } else if (type == 3) { // Find First >= X
+            int l, r, x; cin >> l >> r >> x;
+            cout << st.find_first(l-1, r-1, [&](ll val) { return val >= x; }) + 1 << "\n";
+        }
+    }
+}
+*/
@@ -0,0 +1,200 @@
+#ifndef ORDERED_TREAP_H
+#define ORDERED_TREAP_H
+
+#include "template.h"
+#include "treap.h"
+
+/**
+ * Keyed Treap (Ordered Multiset with Order Statistics)
+ * Same NodeArena as Treap; duplicates allowed. Replaces pbds tree / multiset
+ * when rank and select are needed (0-indexed ranks).
+ * * USAGE:
+ * OrderedTreap<int> s;
+ * s.insert(x);
+ * s.erase(x);                       // removes ONE copy, false if absent
+ * int k = s.order_of_key(x);        // # elements < x
+ * int v = s.find_by_order(k);       // k-th smallest
+ * auto it = s.lower_bound(x);       // optional<T>: smallest element >= x
+ * int c = s.count(lo, hi);          // # elements in [lo, hi]
+ * * COMPLEXITY: O(log N) for all operations, no recursion
+ */
+template<typename T>
+struct OrderedTreap {
+    struct Node {
+        T key;
+        unsigned prio;
+        int sz;
+        int l, r; // Arena indices, 0 = null
+
+        // Default = null sentinel
+        Node() : key(), prio(0), sz(0), l(0), r(0) {}
+        Node(const T& k, unsigned p) : key(k), prio(p), sz(1), l(0), r(0) {}
+    };
+
+    NodeArena<Node> t;
+    int root;
+    mt19937 rng;
+    vector<int> path; // Scratch stack of split / merge / erase
+
+    OrderedTreap() : root(0) {
+        rng.seed(chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    // --- Helpers ---
+    int get_sz(int x) const { return t[x].sz; }
+
+    void pull(int x) { t[x].sz = 1 + t[t[x].l].sz + t[t[x].r].sz; }
+
+    // Keys < key go to a, the rest to b (bottom-up relink as in Treap::split)
+    void split(int x, const T& key, int &a, int &b) {
+        path.clear();
+        while (x) {
+            if (t[x].key < key) { path.push_back(-x); x = t[x].r; }
+            else { path.push_back(x); x = t[x].l; }
+        }
+        a = b = 0;
+        for (int i = (int)path.size() - 1; i >= 0; --i) {
+            int y = abs(path[i]);
+            if (path[i] > 0) { t[y].l = b; b = y; }
+            else { t[y].r = a; a = y; }
+            pull(y);
+        }
+    }
+
+    // Every key of a <= every key of b
+    int merge(int a, int b) {
+        path.clear();
+        while (a && b) {
+            if (t[a].prio > t[b].prio) { path.push_back(-a); a = t[a].r; }
+            else { path.push_back(b); b = t[b].l; }
+        }
+        int cur = a ? a : b;
+        for (int i = (int)path.size() - 1; i >= 0; --i) {
+            int y = path[i];
+            if (y > 0) t[y].l = cur;
+            else { y = -y; t[y].r = cur; }
+            pull(y);
+            cur = y;
+        }
+        return cur;
+    }
+
+    // --- Operations ---
+
+    // Walks down to the node's heap position (sizes bumped on the way),
+    // then splits the subtree there around 'key': one pass, no rebalancing
+    void insert(const T& key) {
+        int nd = t.alloc(Node(key, rng()));
+        int* slot = &root; // No allocation below: pointers into the arena stay valid
+        while (*slot && t[*slot].prio > t[nd].prio) {
+            Node& x = t[*slot];
+            x.sz++;
+            slot = key < x.key ? &x.l : &x.r;
+        }
+        split(*slot, key, t[nd].l, t[nd].r);
+        pull(nd);
+        *slot = nd;
+    }
+
+    // Removes one copy of 'key' (node goes back to the arena)
+    bool erase(const T& key) {
+        int* slot = &root;
+        path.clear();
+        while (*slot) {
+            Node& x = t[*slot];
+            if (!(key < x.key) && !(x.key < key)) break;
+            path.push_back(*slot);
+            slot = key < x.key ? &x.l : &x.r;
+        }
+        if (!*slot) return false;
+        for (int y : path) t[y].sz--;
+        int x = *slot;
+        *slot = merge(t[x].l, t[x].r);
+        t.release(x);
+        return true;
+    }
+
+    // # elements < key
+    int order_of_key(const T& key) const {
+        int res = 0;
+        for (int x = root; x; ) {
+            if (t[x].key < key) { res += t[t[x].l].sz + 1; x = t[x].r; }
+            else x = t[x].l;
+        }
+        return res;
+    }
+
+    // # elements <= key
+    int order_of_key_le(const T& key) const {
+        int res = 0;
+        for (int x = root; x; ) {
+            if (!(key < t[x].key)) { res += t[t[x].l].sz + 1; x = t[x].r; }
+            else x = t[x].l;
+        }
+        return res;
+    }
+
+    // k-th smallest (0-indexed), k < size()
+    T find_by_order(int k) const {
+        int x = root;
+        while (x) {
+            int ls = t[t[x].l].sz;
+            if (k == ls) return t[x].key;
+            if (k < ls) x = t[x].l;
+            else { k -= ls + 1; x = t[x].r; }
+        }
+        return T(); // Should not happen
+    }
+
+    // Smallest element >= key
+    optional<T> lower_bound(const T& key) const {
+        optional<T> res;
+        for (int x = root; x; ) {
+            if (t[x].key < key) x = t[x].r;
+            else { res = t[x].key; x = t[x].l; }
+        }
+        return res;
+    }
+
+    // Smallest element > key
+    optional<T> upper_bound(const T& key) const {
+        optional<T> res;
+        for (int x = root; x; ) {
+            if (!(key < t[x].key)) x = t[x].r;
+            else { res = t[x].key; x = t[x].l; }
+        }
+        return res;
+    }
+
+    // # elements in [lo, hi]
+    int count(const T& lo, const T& hi) const {
+        if (hi < lo) return 0;
+        return order_of_key_le(hi) - order_of_key(lo);
+    }
+
+    int size() const { return get_sz(root); }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve() {
+    int q;
+    cin >> q;
+    OrderedTreap<int> s;
+
+    while(q--) {
+        int type, x; cin >> type >> x;
+        if (type == 1) s.insert(x);
+        else if (type == 2) s.erase(x);
+        else if (type == 3) cout << s.order_of_key(x) << "\n";      // rank of x
+        else if (type == 4) cout << s.find_by_order(x - 1) << "\n"; // x-th smallest
+        else { // successor
+            auto it = s.lower_bound(x);
+            cout << (it ? *it : -1) << "\n";
+        }
+    }
+}
+*/
@@ -0,0 +1,163 @@
+#ifndef PERSISTENT_TREAP_H
+#define PERSISTENT_TREAP_H
+
+#include "template.h"
+#include "treap.h"
+
+/**
+ * Persistent Implicit Treap (Sequence with versions / undo)
+ * Runs the Treap split / merge core with PERSISTENT = true: every node an
+ * operation touches is copied into the arena first (at most once per
+ * operation), so older roots keep seeing their own sequence.
+ * * USAGE:
+ * // 1. Build version 0 (same Action policies as Treap, default: add / sum + max)
+ * PersistentTreap<long long> pt(initial_vector);
+ * // 2. Every modification takes a version root and returns a NEW root
+ * int v1 = pt.insert(pt.roots[0], pos, val);
+ * pt.roots.push_back(v1);                          // snapshot = O(1), just the root
+ * pt.roots.push_back(pt.reverse(v1, l, r));
+ * // 3. Read any version (query / get never allocate)
+ * auto agg = pt.query(pt.roots[k], l, r);          // .sum / .mx for the default policy
+ * * COMPLEXITY: O(log N) per operation on any version
+ * * MEMORY: O(log N) new nodes per modification (path copies plus the children
+ *   that receive a pushed tag), nodes are never freed
+ */
+template<typename T, typename Action = TreapSumMax<T>>
+struct PersistentTreap : Treap<T, Action, true> {
+    using Base = Treap<T, Action, true>;
+    using Policy = typename Base::Policy;
+    using S = typename Base::S;
+    using F = typename Base::F;
+    using Node = typename Base::Node;
+    using Base::t;
+
+    vector<int> roots; // Stores root index of each version
+
+    PersistentTreap() { roots.push_back(0); }
+
+    PersistentTreap(const vector<T>& v) : Base(v) { roots.push_back(this->root); }
+
+    // Runs 'op' (a Treap operation) on version 'rt' and returns the new root.
+    // Nodes allocated from here on belong to this operation and are modified in place.
+    template<typename Op>
+    int modify(int rt, Op op) {
+        this->root = rt;
+        this->fresh = t.pool.size();
+        op();
+        return this->root;
+    }
+
+    // --- Modifications (0-indexed, return the NEW root) ---
+    int insert(int rt, int pos, T val) { return modify(rt, [&] { Base::insert(pos, val); }); }
+    int erase(int rt, int pos) { return modify(rt, [&] { Base::erase(pos); }); }
+    int set(int rt, int pos, T val) { return modify(rt, [&] { Base::set(pos, val); }); }
+    int update(int rt, int l, int r, const F& f) { return modify(rt, [&] { Base::update(l, r, f); }); }
+    int reverse(int rt, int l, int r) { return modify(rt, [&] { Base::reverse(l, r); }); }
+    int move(int rt, int l, int r, int pos) { return modify(rt, [&] { Base::move(l, r, pos); }); }
+    int erase_range(int rt, int l, int r) { return modify(rt, [&] { Base::erase_range(l, r); }); }
+
+    template<typename It>
+    int insert_range(int rt, int pos, It first, It last) {
+        return modify(rt, [&] { Base::insert_range(pos, first, last); });
+    }
+
+    // --- Reads (no allocation) ---
+    // Pending ancestor tags are composed on the way down, 'rev' is the
+    // reverse parity that reaches the node.
+
+    int size(int rt) const { return t[rt].sz; }
+
+    T get(int rt, int pos) const {
+        int x = rt;
+        F f = Policy::id();
+        bool rev = false;
+        while (x) {
+            const Node& nd = t[x];
+            rev ^= nd.rev;
+            int L = rev ? nd.r : nd.l, R = rev ? nd.l : nd.r;
+            int ls = t[L].sz;
+            if (pos == ls) return Policy::apply(f, nd.val);
+            f = Policy::composition(f, nd.tag);
+            if (pos < ls) x = L;
+            else { pos -= ls + 1; x = R; }
+        }
+        return T(); // Should not happen
+    }
+
+    // Range Query [l, r] on version 'rt'
+    S query(int rt, int l, int r) const {
+        return query(rt, l, r, Policy::id(), false);
+    }
+
+    S query(int x, int l, int r, const F& f, bool rev) const {
+        if (!x || r < 0 || l >= t[x].sz) return Policy::e();
+        const Node& nd = t[x];
+        if (l <= 0 && nd.sz - 1 <= r) return Policy::mapping(f, nd.agg, nd.sz);
+        rev ^= nd.rev;
+        int L = rev ? nd.r : nd.l, R = rev ? nd.l : nd.r;
+        int ls = t[L].sz;
+        F down = Policy::composition(f, nd.tag);
+        S res = query(L, l, r, down, rev);
+        if (l <= ls && ls <= r) res = Policy::op(res, Policy::lift(Policy::apply(f, nd.val)));
+        return Policy::op(res, query(R, l - ls - 1, r - ls - 1, down, rev));
+    }
+
+    // Sequence of version 'rt' (explicit stack of {node, pending tag, reverse parity})
+    vector<T> to_vector(int rt) const {
+        vector<T> res;
+        res.reserve(size(rt));
+        vector<tuple<int, F, bool>> st;
+        auto descend = [&](int x, F f, bool rev) {
+            for (; x; ) {
+                rev ^= t[x].rev;
+                st.emplace_back(x, f, rev);
+                f = Policy::composition(f, t[x].tag);
+                x = rev ? t[x].r : t[x].l;
+            }
+        };
+        descend(rt, Policy::id(), false);
+        while (!st.empty()) {
+            auto [x, f, rev] = st.back();
+            st.pop_back();
+            res.push_back(Policy::apply(f, t[x].val));
+            descend(rev ? t[x].l : t[x].r, Policy::composition(f, t[x].tag), rev);
+        }
+        return res;
+    }
+
+    // Nodes allocated so far (sentinel excluded)
+    int nodes() const { return t.pool.size() - 1; }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve() {
+    int n, q;
+    cin >> n >> q;
+    vector<long long> a(n);
+    for(auto& x : a) cin >> x;
+
+    // Version 0 (Range Add / Range Sum + Max)
+    PersistentTreap<long long> pt(a);
+
+    while(q--) {
+        int type, k; cin >> type >> k; // every query names the version it works on
+        if (type == 1) { // Insert x at pos -> new version
+            int pos; long long x; cin >> pos >> x;
+            pt.roots.push_back(pt.insert(pt.roots[k], pos - 1, x));
+        } else if (type == 2) { // Reverse [l, r] -> new version
+            int l, r; cin >> l >> r;
+            pt.roots.push_back(pt.reverse(pt.roots[k], l - 1, r - 1));
+        } else if (type == 3) { // Add x on [l, r] -> new version
+            int l, r; long long x; cin >> l >> r >> x;
+            pt.roots.push_back(pt.update(pt.roots[k], l - 1, r - 1, x));
+        } else { // Range sum on version k
+            int l, r; cin >> l >> r;
+            cout << pt.query(pt.roots[k], l - 1, r - 1).sum << "\n";
+        }
+    }
+}
+*/
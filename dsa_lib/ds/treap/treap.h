@@ -2,100 +2,298 @@
 #define TREAP_H
 
 #include "template.h"
+#include "monoids.h"
+
+/**
+ * Index-based Node Arena
+ * Nodes live contiguously in one vector and link through 32-bit indices.
+ * Index 0 is a reserved null sentinel; freed indices are recycled (free list).
+ * Node must be default constructible (the default Node is the sentinel).
+ */
+template<typename Node>
+struct NodeArena {
+    vector<Node> pool;
+    vector<int> free_ids;
+
+    NodeArena() { pool.emplace_back(); }
+
+    Node& operator[](int i) { return pool[i]; }
+    const Node& operator[](int i) const { return pool[i]; }
+
+    int alloc(const Node& nd) {
+        if (!free_ids.empty()) {
+            int id = free_ids.back();
+            free_ids.pop_back();
+            pool[id] = nd;
+            return id;
+        }
+        pool.push_back(nd);
+        return pool.size() - 1;
+    }
+
+    void release(int id) { if (id) free_ids.push_back(id); }
+
+    void reserve(int n) { pool.reserve(n + 1); }
+
+    // Nodes currently in use (excluding the sentinel)
+    int live() const { return pool.size() - 1 - free_ids.size(); }
+};
+
+/**
+ * Treap Policies
+ * A Treap takes an ACTION from monoids.h (aggregate type == value type), e.g.
+ * Treap<ll, RangeAffineSum<ll>>. When the aggregate differs from the stored
+ * value (several aggregates at once), the policy also defines:
+ * using S;                                  // aggregate type (e(), op(), mapping() work on S)
+ * static S lift(const T& v);                // aggregate of the single value v
+ * static T apply(const F& f, const T& v);   // tag applied to one stored value
+ * reverse() assumes op is commutative (the aggregate of a range is not flipped).
+ */
+
+// Default: Range Add / Range Sum + Range Max (the classic query_sum / query_max)
+template<typename T>
+struct TreapSumMax {
+    struct S { long long sum; T mx; };
+    using F = T;
+    static S e() { return {0, numeric_limits<T>::lowest()}; }
+    static S op(const S& a, const S& b) { return {a.sum + b.sum, max(a.mx, b.mx)}; }
+    static S lift(const T& v) { return {(long long)v, v}; }
+    static constexpr F id() { return F(0); }
+    static S mapping(const F& f, const S& x, long long len) {
+        return {x.sum + (long long)f * len, x.mx == numeric_limits<T>::lowest() ? x.mx : x.mx + f};
+    }
+    static T apply(const F& f, const T& v) { return v + f; }
+    static F composition(const F& f, const F& g) { return f + g; }
+};
+
+// Lifts a monoids.h Action (no 'S') to the Treap policy interface
+template<typename A, typename T, typename = void>
+struct TreapPolicy : A {
+    using S = T;
+    static S lift(const T& v) { return v; }
+    static T apply(const typename A::F& f, const T& v) { return A::mapping(f, v, 1); }
+};
+template<typename A, typename T>
+struct TreapPolicy<A, T, void_t<typename A::S>> : A {};
 
 /**
  * Implicit Treap (Array with powerful range operations)
  * * USAGE:
- * Treap<int> t(initial_vector);
+ * Treap<int> t(initial_vector);    // O(N) build, default policy: add / sum + max
+ * t.build(first, last);            // O(N) rebuild from any iterator range
  * t.insert(pos, val);
+ * t.insert_range(pos, first, last); // O(K + log N) block insert
+ * t.erase_range(l, r);               // O(K + log N), nodes are reused
  * t.reverse(l, r);
+ * t.update(l, r, f);               // lazy range action
+ * for (int x : t) ...              // in-order iteration, no to_vector copy
  * long long sum = t.query_sum(l, r);
+ * Treap<ll, RangeAffineSum<ll>> ta(a);   // any Action policy from monoids.h
+ * ta.update(l, r, {2, 3});
+ * ll s = ta.query(l, r);
+ * * MEMORY: Nodes in a NodeArena (32-bit links, erased nodes are reused)
+ * * NO RECURSION: split / merge / iteration keep explicit stacks
+ * * PERSISTENT = true: split / merge copy the nodes they touch instead of
+ *   relinking them (see PersistentTreap in persistant_treap.h)
  * * COMPLEXITY: O(log N) for all operations
  */
-template<typename T>
+template<typename T, typename Action = TreapSumMax<T>, bool PERSISTENT = false>
 struct Treap {
+    using Policy = TreapPolicy<Action, T>;
+    using S = typename Policy::S;
+    using F = typename Policy::F;
+
     struct Node {
         T val;
-        int prio;
+        unsigned prio;
         int sz;
-        long long sum;
-        T mx;
+        S agg;    // Aggregate of the subtree, own tag already applied
+        F tag;    // Pending for the children
         bool rev; // Lazy reverse flag
-        Node *l, *r;
+        int l, r; // Arena indices, 0 = null
 
-        Node(T v, int p) : val(v), prio(p), sz(1), sum(v), mx(v), 
-                           rev(false), l(nullptr), r(nullptr) {}
+        // Default = null sentinel: empty size, identity aggregate
+        Node() : val(), prio(0), sz(0), agg(Policy::e()), tag(Policy::id()), rev(false), l(0), r(0) {}
+        Node(T v, unsigned p) : val(v), prio(p), sz(1), agg(Policy::lift(v)), tag(Policy::id()),
+                                rev(false), l(0), r(0) {}
     };
 
-    Node* root;
+    NodeArena<Node> t;
+    int root;
     mt19937 rng;
+    vector<int> path; // Scratch stack of split / merge
+    int fresh;        // PERSISTENT: nodes >= fresh belong to the running operation
 
     // Default Constructor
-    Treap() : root(nullptr) {
+    Treap() : root(0), fresh(0) {
         rng.seed(chrono::steady_clock::now().time_since_epoch().count());
     }
 
-    // Constructor from vector
-    Treap(const vector<T>& v) : root(nullptr) {
+    // Constructor from vector: O(N)
+    Treap(const vector<T>& v) : root(0), fresh(0) {
         rng.seed(chrono::steady_clock::now().time_since_epoch().count());
-        for(const T& x : v) append(x);
+        build(v.begin(), v.end());
     }
 
     // --- Helpers ---
-    int get_sz(Node* t) { return t ? t->sz : 0; }
-    long long get_sum(Node* t) { return t ? t->sum : 0; }
-    T get_mx(Node* t) { return t ? t->mx : numeric_limits<T>::lowest(); }
-
-    void pull(Node* t) {
-        if (!t) return;
-        t->sz = 1 + get_sz(t->l) + get_sz(t->r);
-        t->sum = t->val + get_sum(t->l) + get_sum(t->r);
-        t->mx = max({t->val, get_mx(t->l), get_mx(t->r)});
+    // The sentinel t[0] answers size 0 / identity aggregate, no null checks needed
+    int get_sz(int x) const { return t[x].sz; }
+    S get_agg(int x) const { return t[x].agg; }
+
+    int new_node(T val) { return t.alloc(Node(val, rng())); }
+
+    // Node x made safe to modify: itself, or a private copy if it may be shared
+    int own(int x) {
+        if (!PERSISTENT || !x || x >= fresh) return x;
+        Node nd = t[x];
+        return t.alloc(nd);
     }
 
-    void push(Node* t) {
-        if (!t || !t->rev) return;
-        t->rev = false;
-        swap(t->l, t->r);
-        if (t->l) t->l->rev ^= 1;
-        if (t->r) t->r->rev ^= 1;
+    void pull(int x) {
+        if (!x) return;
+        Node& nd = t[x];
+        nd.sz = 1 + t[nd.l].sz + t[nd.r].sz;
+        nd.agg = Policy::op(Policy::op(t[nd.l].agg, Policy::lift(nd.val)), t[nd.r].agg);
     }
 
-    void split(Node* t, int k, Node* &a, Node* &b) {
-        if (!t) { a = b = nullptr; return; }
-        push(t);
-        if (get_sz(t->l) >= k) {
-            split(t->l, k, a, t->l);
-            b = t;
-        } else {
-            split(t->r, k - get_sz(t->l) - 1, t->r, b);
-            a = t;
+    // Applies 'f' to the whole subtree x
+    void apply_node(int x, const F& f) {
+        if (!x) return;
+        Node& nd = t[x];
+        nd.val = Policy::apply(f, nd.val);
+        nd.agg = Policy::mapping(f, nd.agg, nd.sz);
+        nd.tag = Policy::composition(f, nd.tag);
+    }
+
+    void push(int x) {
+        if (!x || (!t[x].rev && t[x].tag == Policy::id())) return;
+        if (PERSISTENT) {
+            int a = own(t[x].l), b = own(t[x].r);
+            t[x].l = a; t[x].r = b;
+        }
+        Node& nd = t[x];
+        if (nd.rev) {
+            nd.rev = false;
+            swap(nd.l, nd.r);
+            if (nd.l) t[nd.l].rev ^= 1;
+            if (nd.r) t[nd.r].rev ^= 1;
+        }
+        if (!(nd.tag == Policy::id())) {
+            apply_node(nd.l, nd.tag);
+            apply_node(nd.r, nd.tag);
+            nd.tag = Policy::id();
         }
-        pull(t);
     }
+    // Split / merge walk down iteratively and record the visited nodes in 'path'
+    // (negated when the node keeps its left side), then relink and pull them
+    // bottom-up. Only the tree depth is stored, no call stack (safe at any N).
 
-    Node* merge(Node* a, Node* b) {
-        if (!a || !b) return a ? a : b;
-        if (a->prio > b->prio) {
-            push(a);
-            a->r = merge(a->r, b);
-            pull(a);
-            return a;
-        } else {
-            push(b);
-            b->l = merge(a, b->l);
-            pull(b);
-            return b;
+    // First k elements of x go to a, the rest to b
+    void split(int x, int k, int &a, int &b) {
+        path.clear();
+        while (x) {
+            x = own(x);
+            push(x);
+            int ls = t[t[x].l].sz;
+            if (ls >= k) {
+                path.push_back(x);   // x and its right subtree go to b
+                x = t[x].l;
+            } else {
+                k -= ls + 1;
+                path.push_back(-x);  // x and its left subtree go to a
+                x = t[x].r;
+            }
+        }
+        a = b = 0;
+        for (int i = (int)path.size() - 1; i >= 0; --i) {
+            int y = abs(path[i]);
+            if (path[i] > 0) { t[y].l = b; b = y; }
+            else { t[y].r = a; a = y; }
+            pull(y);
+        }
+    }
+
+    int merge(int a, int b) {
+        path.clear();
+        while (a && b) {
+            if (t[a].prio > t[b].prio) {
+                a = own(a);
+                push(a);
+                path.push_back(-a);  // a keeps its left subtree
+                a = t[a].r;
+            } else {
+                b = own(b);
+                push(b);
+                path.push_back(b);   // b keeps its right subtree
+                b = t[b].l;
+            }
+        }
+        int cur = a ? a : b;
+        for (int i = (int)path.size() - 1; i >= 0; --i) {
+            int y = path[i];
+            if (y > 0) t[y].l = cur;
+            else { y = -y; t[y].r = cur; }
+            pull(y);
+            cur = y;
         }
+        return cur;
+    }
+
+    // Returns every node of subtree x to the arena (no-op if PERSISTENT: nodes are shared).
+    // A single node (erase) is freed directly, larger subtrees reuse the 'path' scratch stack.
+    void release(int x) {
+        if (PERSISTENT || !x) return;
+        if (!t[x].l && !t[x].r) { t.release(x); return; }
+        path.clear();
+        path.push_back(x);
+        while (!path.empty()) {
+            int u = path.back(); path.pop_back();
+            if (t[u].l) path.push_back(t[u].l);
+            if (t[u].r) path.push_back(t[u].r);
+            t.release(u);
+        }
+    }
+
+    // Builds a detached treap over [first, last) in O(N) and returns its root.
+    // Cartesian tree on random priorities: 'st' is the right spine, a node popped
+    // off it is complete and gets pulled right away.
+    template<typename It>
+    int build_tree(It first, It last) {
+        vector<int> st;
+        for (; first != last; ++first) {
+            int x = new_node(*first), prev = 0;
+            while (!st.empty() && t[st.back()].prio < t[x].prio) {
+                prev = st.back();
+                st.pop_back();
+                pull(prev);
+            }
+            t[x].l = prev;
+            if (!st.empty()) t[st.back()].r = x;
+            st.push_back(x);
+        }
+        for (int i = (int)st.size() - 1; i >= 0; --i) pull(st[i]);
+        return st.empty() ? 0 : st[0];
+    }
+
+    // Replaces the contents with [first, last) in O(N).
+    // Single-pass ranges (istream_iterator) are read once, without the reserve.
+    template<typename It>
+    void build(It first, It last) {
+        release(root);
+        using Cat = typename iterator_traits<It>::iterator_category;
+        if constexpr (is_base_of<forward_iterator_tag, Cat>::value) {
+            t.reserve(t.live() + distance(first, last));
+        }
+        root = build_tree(first, last);
     }
 
     // --- Core Operations (0-indexed) ---
 
     // Insert 'val' at 'pos' (0 <= pos <= size)
     void insert(int pos, T val) {
-        Node *L, *R;
+        int nd = new_node(val);
+        int L, R;
         split(root, pos, L, R);
-        Node* nd = new Node(val, (int)rng());
         root = merge(merge(L, nd), R);
     }
 
@@ -104,26 +302,44 @@ struct Treap {
         insert(get_sz(root), val);
     }
 
-    // Erase element at 'pos'
+    // Erase element at 'pos' (node goes back to the arena)
     void erase(int pos) {
-        Node *L, *mid, *R;
+        int L, mid, R;
         split(root, pos, L, R);
         split(R, 1, mid, R);
-        // delete mid; // Optional: free memory
+        release(mid);
+        root = merge(L, R);
+    }
+
+    // Insert [first, last) before 'pos': O(K) build + one split + two merges
+    template<typename It>
+    void insert_range(int pos, It first, It last) {
+        int nd = build_tree(first, last);
+        int L, R;
+        split(root, pos, L, R);
+        root = merge(merge(L, nd), R);
+    }
+
+    // Erase range [l, r] (nodes go back to the arena): O(K + log N)
+    void erase_range(int l, int r) {
+        int L, mid, R;
+        split(root, r + 1, L, R);
+        split(L, l, L, mid);
+        release(mid);
         root = merge(L, R);
     }
 
     // Get value at 'pos'
     T get(int pos) {
-        Node* curr = root;
+        int curr = root;
         while (curr) {
             push(curr);
-            int left_sz = get_sz(curr->l);
-            if (pos == left_sz) return curr->val;
-            if (pos < left_sz) curr = curr->l;
+            int left_sz = get_sz(t[curr].l);
+            if (pos == left_sz) return t[curr].val;
+            if (pos < left_sz) curr = t[curr].l;
             else {
                 pos -= left_sz + 1;
-                curr = curr->r;
+                curr = t[curr].r;
             }
         }
         return T(); // Should not happen
@@ -131,44 +347,46 @@ struct Treap {
 
     // Set value at 'pos'
     void set(int pos, T val) {
-        Node *L, *mid, *R;
+        int L, mid, R;
         split(root, pos, L, R);
         split(R, 1, mid, R);
         if (mid) {
             push(mid);
-            mid->val = mid->sum = mid->mx = val; // Reset logic
-            // Note: If T is complex, you might need manual pull logic here
-            pull(mid); 
+            t[mid].val = val;
+            pull(mid);
         }
         root = merge(merge(L, mid), R);
     }
 
-    // Range Sum [l, r]
-    long long query_sum(int l, int r) {
-        Node *L, *mid, *R;
+    // Range Query [l, r]: aggregate under the policy
+    S query(int l, int r) {
+        int L, mid, R;
         split(root, r + 1, L, R);
         split(L, l, L, mid);
-        long long ans = get_sum(mid);
+        S ans = get_agg(mid);
         root = merge(merge(L, mid), R);
         return ans;
     }
 
-    // Range Max [l, r]
-    T query_max(int l, int r) {
-        Node *L, *mid, *R;
+    // Range Update [l, r]: apply tag 'f' lazily
+    void update(int l, int r, const F& f) {
+        int L, mid, R;
         split(root, r + 1, L, R);
         split(L, l, L, mid);
-        T ans = get_mx(mid);
+        apply_node(mid, f);
         root = merge(merge(L, mid), R);
-        return ans;
     }
 
+    // Range Sum / Range Max [l, r] (default TreapSumMax policy)
+    long long query_sum(int l, int r) { return query(l, r).sum; }
+    T query_max(int l, int r) { return query(l, r).mx; }
+
     // Reverse range [l, r]
     void reverse(int l, int r) {
-        Node *L, *mid, *R;
+        int L, mid, R;
         split(root, r + 1, L, R);
         split(L, l, L, mid);
-        if (mid) mid->rev ^= 1;
+        if (mid) t[mid].rev ^= 1;
         root = merge(merge(L, mid), R);
     }
 
@@ -178,9 +396,9 @@ struct Treap {
     void move(int l, int r, int pos) {
         if (!root || (pos >= l && pos <= r)) return;
         int len = r - l + 1;
-        
-        Node *P, *Q, *B, *R_part, *temp, *temp2;
-        
+
+        int P, Q, B, R_part, temp, temp2;
+
         if (pos < l) {
             // Move block B=[l..r] to before l (at pos)
             // Original: P[0..pos-1], Q[pos..l-1], B[l..r], R_part[r+1..]
@@ -195,26 +413,51 @@ struct Treap {
             // Target:   P, Q, B, R_part
             split(root, l, P, temp);
             split(temp, len, B, temp2);
-            int q_len = pos - l; 
+            int q_len = pos - l;
             split(temp2, q_len, Q, R_part);
             root = merge(P, merge(Q, merge(B, R_part)));
         }
     }
 
+    // In-order iterator: walks the left spine on an explicit stack, pushing lazy
+    // tags on the way (no copy of the sequence). Invalidated by any modification.
+    struct iterator {
+        Treap* tr;
+        vector<int> st;
+
+        iterator(Treap* _tr = nullptr, int x = 0) : tr(_tr) { descend(x); }
+
+        void descend(int x) {
+            for (; x; x = tr->t[x].l) {
+                tr->push(x);
+                st.push_back(x);
+            }
+        }
+
+        const T& operator*() const { return tr->t[st.back()].val; }
+        iterator& operator++() {
+            int x = st.back();
+            st.pop_back();
+            descend(tr->t[x].r);
+            return *this;
+        }
+        bool operator==(const iterator& o) const {
+            return st.empty() ? o.st.empty() : !o.st.empty() && st.back() == o.st.back();
+        }
+        bool operator!=(const iterator& o) const { return !(*this == o); }
+    };
+
+    iterator begin() { return iterator(this, root); }
+    iterator end() { return iterator(this); }
+
     // Convert to vector
     vector<T> to_vector() {
         vector<T> res;
-        auto dfs = [&](auto&& self, Node* t) -> void {
-            if (!t) return;
-            push(t);
-            self(self, t->l);
-            res.push_back(t->val);
-            self(self, t->r);
-        };
-        dfs(dfs, root);
+        res.reserve(size());
+        for (iterator it = begin(); it != end(); ++it) res.push_back(*it);
         return res;
     }
-    
+
     int size() { return get_sz(root); }
 };
 
@@ -226,7 +469,7 @@ Usage Example:
 void solve() {
     int n, q;
     cin >> n >> q;
-    
+
     // 1. Build from vector
     vi a(n);
     for(int& x : a) cin >> x;
@@ -243,6 +486,10 @@ void solve() {
             int l, r; cin >> l >> r;
             cout << t.query_sum(l, r) << "\n";
         }
+        else if(type == 'A') { // Add x on [l, r]
+            int l, r, x; cin >> l >> r >> x;
+            t.update(l, r, x);
+        }
         else if(type == 'R') { // Reverse [l, r]
             int l, r; cin >> l >> r;
             t.reverse(l, r);
@@ -252,10 +499,10 @@ void solve() {
             t.move(l, r, pos);
         }
     }
-    
+
     // 3. Print final array
     vi final_arr = t.to_vector();
     for(int x : final_arr) cout << x << " ";
     cout << "\n";
 }
-*/
\ No newline at end of file
+*/
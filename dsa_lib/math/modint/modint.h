@@ -0,0 +1,206 @@
+#ifndef MODINT_H
+#define MODINT_H
+
+#include "template.h"
+
+/**
+ * Modular Integer Types (no hardware division in the hot path)
+ * * USAGE:
+ * // 1. Compile-time modulus (Montgomery form, MOD odd and < 2^30)
+ * using mint = ModInt<998244353>;
+ * mint a = 5, b = a.pow(100) * a.inv();
+ * cout << b.val() << "\n";
+ * // 2. Runtime modulus (Barrett reduction, 1 <= m < 2^31)
+ * DynModInt<>::set_mod(m);
+ * DynModInt<> x = 7; x *= x;
+ * // 3. Runtime 64-bit odd modulus (Montgomery, used by PollardRho)
+ * Montgomery64 mg(n);
+ * u64 r = mg.from(mg.mul(mg.to(a), mg.to(b)));
+ * * COMPLEXITY: O(1) per op, O(log e) for pow
+ */
+template<unsigned MOD>
+struct ModInt {
+    static_assert(MOD % 2 == 1 && MOD < (1u << 30), "MOD must be odd and < 2^30");
+    using u32 = unsigned;
+    using u64 = unsigned long long;
+
+    // -MOD^{-1} mod 2^32 (Newton iteration) and R^2 mod MOD with R = 2^32
+    static constexpr u32 neg_inv() {
+        u32 inv = MOD;
+        for (int i = 0; i < 4; ++i) inv *= 2 - MOD * inv;
+        return -inv;
+    }
+    static constexpr u32 NINV = neg_inv();
+    static constexpr u64 R1 = (1ULL << 32) % MOD;
+    static constexpr u32 R2 = (u32)(R1 * R1 % MOD);
+
+    u32 v; // Montgomery representation x * R mod MOD, kept in [0, MOD)
+
+    // Montgomery reduction: x * R^{-1} mod MOD, for x < MOD * 2^32
+    static u32 reduce(u64 x) {
+        u32 r = (u32)((x + (u64)((u32)x * NINV) * MOD) >> 32);
+        return r >= MOD ? r - MOD : r;
+    }
+
+    ModInt() : v(0) {}
+    ModInt(long long x) {
+        x %= (long long)MOD;
+        if (x < 0) x += MOD;
+        v = reduce((u64)x * R2);
+    }
+
+    static constexpr u32 mod() { return MOD; }
+    u32 val() const { return reduce(v); }
+
+    ModInt& operator+=(const ModInt& o) { v += o.v; if (v >= MOD) v -= MOD; return *this; }
+    ModInt& operator-=(const ModInt& o) { v += MOD - o.v; if (v >= MOD) v -= MOD; return *this; }
+    ModInt& operator*=(const ModInt& o) { v = reduce((u64)v * o.v); return *this; }
+    ModInt& operator/=(const ModInt& o) { return *this *= o.inv(); }
+
+    friend ModInt operator+(ModInt a, const ModInt& b) { return a += b; }
+    friend ModInt operator-(ModInt a, const ModInt& b) { return a -= b; }
+    friend ModInt operator*(ModInt a, const ModInt& b) { return a *= b; }
+    friend ModInt operator/(ModInt a, const ModInt& b) { return a /= b; }
+    ModInt operator-() const { return ModInt() - *this; }
+    bool operator==(const ModInt& o) const { return v == o.v; }
+    bool operator!=(const ModInt& o) const { return v != o.v; }
+
+    ModInt pow(long long e) const {
+        ModInt base = *this, res = 1;
+        for (; e > 0; e >>= 1, base *= base)
+            if (e & 1) res *= base;
+        return res;
+    }
+
+    // Requires MOD prime (Fermat)
+    ModInt inv() const { return pow(MOD - 2); }
+
+    friend ostream& operator<<(ostream& os, const ModInt& x) { return os << x.val(); }
+};
+
+template<int ID = 0>
+struct DynModInt {
+    using u32 = unsigned;
+    using u64 = unsigned long long;
+
+    // Barrett constants: im = ceil(2^64 / m)
+    static inline u32 m = 1;
+    static inline u64 im = 0;
+
+    static void set_mod(u32 md) {
+        assert(1 <= md && md < (1u << 31));
+        m = md;
+        im = (u64)(-1) / md + 1;
+    }
+
+    static u32 mod() { return m; }
+
+    // Barrett reduction of a product of two values in [0, m)
+    static u32 mul(u32 a, u32 b) {
+        u64 z = (u64)a * b;
+        u64 x = (u64)(((unsigned __int128)z * im) >> 64);
+        u32 r = (u32)(z - x * m);
+        return m <= r ? r + m : r;
+    }
+
+    u32 v; // Plain residue in [0, m)
+
+    DynModInt() : v(0) {}
+    DynModInt(long long x) {
+        x %= (long long)m;
+        if (x < 0) x += m;
+        v = (u32)x;
+    }
+
+    u32 val() const { return v; }
+
+    DynModInt& operator+=(const DynModInt& o) { v += o.v; if (v >= m) v -= m; return *this; }
+    DynModInt& operator-=(const DynModInt& o) { v += m - o.v; if (v >= m) v -= m; return *this; }
+    DynModInt& operator*=(const DynModInt& o) { v = mul(v, o.v); return *this; }
+    DynModInt& operator/=(const DynModInt& o) { return *this *= o.inv(); }
+
+    friend DynModInt operator+(DynModInt a, const DynModInt& b) { return a += b; }
+    friend DynModInt operator-(DynModInt a, const DynModInt& b) { return a -= b; }
+    friend DynModInt operator*(DynModInt a, const DynModInt& b) { return a *= b; }
+    friend DynModInt operator/(DynModInt a, const DynModInt& b) { return a /= b; }
+    DynModInt operator-() const { return DynModInt() - *this; }
+    bool operator==(const DynModInt& o) const { return v == o.v; }
+    bool operator!=(const DynModInt& o) const { return v != o.v; }
+
+    DynModInt pow(long long e) const {
+        DynModInt base = *this, res = 1;
+        for (; e > 0; e >>= 1, base *= base)
+            if (e & 1) res *= base;
+        return res;
+    }
+
+    // Works for any m as long as gcd(v, m) = 1 (extended Euclid)
+    DynModInt inv() const {
+        long long a = v, b = m, x = 1, y = 0;
+        while (b) {
+            long long q = a / b;
+            swap(a -= q * b, b);
+            swap(x -= q * y, y);
+        }
+        return DynModInt(x);
+    }
+
+    friend ostream& operator<<(ostream& os, const DynModInt& x) { return os << x.val(); }
+};
+
+// Runtime 64-bit Montgomery arithmetic for any odd modulus n.
+// Values passed to mul/add/sub must already be in Montgomery form (see to()).
+struct Montgomery64 {
+    using u64 = uint64_t;
+    using u128 = __uint128_t;
+
+    u64 n, inv, r2;
+
+    Montgomery64(u64 _n) : n(_n) {
+        inv = n; // n^{-1} mod 2^64, Newton steps double the bits (3 -> 96)
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+        r2 = (u64)(-(u128)n % n); // 2^128 mod n
+    }
+
+    // x * 2^{-64} mod n, for x < n * 2^64
+    u64 reduce(u128 x) const {
+        u64 q = (u64)x * inv;
+        u64 hi = (u64)(x >> 64), qn = (u64)(((u128)q * n) >> 64);
+        return hi >= qn ? hi - qn : hi - qn + n;
+    }
+
+    u64 mul(u64 a, u64 b) const { return reduce((u128)a * b); }
+    u64 add(u64 a, u64 b) const { u64 r = a + b; return (r >= n || r < a) ? r - n : r; }
+    u64 sub(u64 a, u64 b) const { return a >= b ? a - b : a - b + n; }
+    u64 to(u64 x) const { return mul(x % n, r2); }
+    u64 from(u64 x) const { return reduce(x); }
+
+    // a in Montgomery form, result in Montgomery form
+    u64 pow(u64 a, u64 e) const {
+        u64 r = to(1);
+        for (; e; e >>= 1, a = mul(a, a))
+            if (e & 1) r = mul(r, a);
+        return r;
+    }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve() {
+    // Compile-time modulus
+    using mint = ModInt<1000000007>;
+    int n; cin >> n;
+    mint fact = 1;
+    for (int i = 1; i <= n; ++i) fact *= i;
+    cout << fact << " " << fact.inv() << "\n";
+
+    // Runtime modulus (read from input)
+    int m; cin >> m;
+    DynModInt<>::set_mod(m);
+    DynModInt<> x = 3;
+    cout << x.pow(n) << "\n";
+}
+*/
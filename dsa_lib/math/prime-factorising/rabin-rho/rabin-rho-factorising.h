@@ -2,6 +2,7 @@
 #define POLLARD_RHO_H
 
 #include "template.h"
+#include "modint.h"
 
 using namespace std;
 
@@ -11,6 +12,7 @@ using namespace std;
  * PollardRho pr;
  * vector<uint64_t> factors = pr.solve(n);
  * * COMPLEXITY: O(n^(1/4)) expected
+ * * All multiplications run in Montgomery form (no 128-bit division)
  * * REQUIRES: C++17 (for std::gcd), GCC/Clang (for __uint128_t)
  */
 struct PollardRho {
@@ -32,20 +34,14 @@ struct PollardRho {
     }
 
 private:
-    // Modular Multiplication (a * b) % m using 128-bit integer
-    u64 mul_mod(u64 a, u64 b, u64 m) {
-        return (u128)a * b % m;
+    // Modular Multiplication (a * b) % n, operands in Montgomery form
+    u64 mul_mod(u64 a, u64 b, const Montgomery64& mg) {
+        return mg.mul(a, b);
     }
 
-    // Modular Exponentiation (a ^ e) % m
-    u64 pow_mod(u64 a, u64 e, u64 m) {
-        u64 r = 1;
-        while (e) {
-            if (e & 1) r = mul_mod(r, a, m);
-            a = mul_mod(a, a, m);
-            e >>= 1;
-        }
-        return r;
+    // Modular Exponentiation (a ^ e) % n, operand and result in Montgomery form
+    u64 pow_mod(u64 a, u64 e, const Montgomery64& mg) {
+        return mg.pow(a, e);
     }
 
     // Miller-Rabin Primality Test (Deterministic for u64)
@@ -64,14 +60,17 @@ private:
             s++;
         }
 
+        Montgomery64 mg(n);
+        const u64 one = mg.to(1), minus_one = mg.to(n - 1);
+
         for (u64 a : bases) {
             if (n <= a) break;
-            u64 x = pow_mod(a, d, n);
-            if (x == 1 || x == n - 1) continue;
+            u64 x = pow_mod(mg.to(a), d, mg);
+            if (x == one || x == minus_one) continue;
             bool composite = true;
             for (int i = 1; i < s; ++i) {
-                x = mul_mod(x, x, n);
-                if (x == n - 1) {
+                x = mul_mod(x, x, mg);
+                if (x == minus_one) {
                     composite = false;
                     break;
                 }
@@ -81,23 +80,40 @@ private:
         return true;
     }
 
-    // Pollard's Rho Algorithm to find a non-trivial factor
+    // Pollard's Rho Algorithm (Brent's cycle detection) to find a non-trivial factor
     u64 get_factor(u64 n) {
         if (n % 2 == 0) return 2;
+        Montgomery64 mg(n);
+        const int BATCH = 128; // |x - y| products per gcd
         
         // Loop until a factor is found
+        // x, y, c, q live in Montgomery form; gcds with n are unaffected since R is coprime to n
         while (true) {
-            u64 x = uniform_int_distribution<u64>(2, n - 1)(rng);
-            u64 y = x;
+            u64 y = uniform_int_distribution<u64>(2, n - 1)(rng);
             u64 c = uniform_int_distribution<u64>(1, n - 1)(rng);
-            u64 d = 1;
+            u64 x = y, ys = y, q = mg.to(1), d = 1;
             
-            auto f = [&](u64 val) { return (mul_mod(val, val, n) + c) % n; };
-
-            while (d == 1) {
-                x = f(x);
-                y = f(f(y));
-                d = std::__gcd((x > y ? x - y : y - x), n);
+            auto f = [&](u64 val) { return mg.add(mul_mod(val, val, mg), c); };
+            auto diff = [](u64 a, u64 b) { return a > b ? a - b : b - a; };
+
+            for (int r = 1; d == 1; r <<= 1) {
+                x = y;
+                for (int i = 0; i < r; ++i) y = f(y);
+                for (int k = 0; k < r && d == 1; k += BATCH) {
+                    ys = y;
+                    for (int i = 0; i < BATCH && i < r - k; ++i) {
+                        y = f(y);
+                        q = mul_mod(q, diff(x, y), mg);
+                    }
+                    d = std::__gcd(q, n);
+                }
+            }
+            // Batch overshot (product hit 0 mod n): replay it one step at a time
+            if (d == n) {
+                do {
+                    ys = f(ys);
+                    d = std::__gcd(diff(x, ys), n);
+                } while (d == 1);
             }
             if (d != n) return d;
         }
@@ -0,0 +1,162 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "template.h"
+
+/**
+ * Fixed Thread Pool + Spin Barrier + Work-Stealing Loop (std::thread only, link with -pthread)
+ * * USAGE:
+ * ThreadPool pool(4);                  // 0 = hardware_concurrency()
+ * pool.run([&](int tid) {              // job runs once on every thread, caller is tid 0
+ *     for (int step = 0; step < steps; ++step) {
+ *         work(step, tid);
+ *         pool.sync();                 // all threads finish 'step' before 'step + 1'
+ *     }
+ * });                                  // returns when every thread is done
+ * pool.for_each(len, 64, [&](int lo, int hi, int tid) {   // uneven work on [0, len)
+ *     for (int i = lo; i < hi; ++i) work(i);
+ * });
+ * * NOTES:
+ * - Workers are started once and sleep between run() calls
+ * - sync() spins briefly, then yields (safe when threads > cores)
+ * - for_each: every thread owns a block of chunks and claims them one by one,
+ *   a thread that runs dry steals chunks from the other blocks
+ */
+struct SpinBarrier {
+    int n;
+    atomic<int> waiting{0};
+    atomic<unsigned> gen{0};
+
+    SpinBarrier(int _n = 1) : n(_n) {}
+
+    void wait() {
+        unsigned g = gen.load(memory_order_acquire);
+        if (waiting.fetch_add(1, memory_order_acq_rel) == n - 1) {
+            waiting.store(0, memory_order_relaxed);
+            gen.fetch_add(1, memory_order_release);
+            return;
+        }
+        for (int spin = 0; gen.load(memory_order_acquire) == g; ++spin) {
+            if (spin >= 64) this_thread::yield();
+        }
+    }
+};
+
+struct ThreadPool {
+    // Chunk counter of one thread's block (own cache line, claimed by fetch_add)
+    struct alignas(64) Slot {
+        atomic<long long> next{0};
+        long long end = 0;
+    };
+
+    int n;
+    vector<thread> workers;
+    SpinBarrier barrier;
+    vector<Slot> slots;
+
+    mutex mtx;
+    condition_variable cv_job, cv_done;
+    function<void(int)> job;
+    unsigned job_gen = 0;
+    int running = 0;
+    bool stop = false;
+
+    ThreadPool(int threads = 0) {
+        n = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+        barrier.n = n;
+        slots = vector<Slot>(n);
+        for (int tid = 1; tid < n; ++tid) workers.emplace_back([this, tid] { loop(tid); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lk(mtx);
+            stop = true;
+        }
+        cv_job.notify_all();
+        for (auto& th : workers) th.join();
+    }
+
+    void loop(int tid) {
+        unsigned seen = 0;
+        while (true) {
+            unique_lock<mutex> lk(mtx);
+            cv_job.wait(lk, [&] { return stop || job_gen != seen; });
+            if (stop) return;
+            seen = job_gen;
+            lk.unlock();
+            job(tid);
+            lk.lock();
+            if (--running == 0) cv_done.notify_one();
+        }
+    }
+
+    // Runs f(tid) for tid = 0 .. n-1 in parallel and waits for all of them
+    void run(function<void(int)> f) {
+        if (n == 1) { f(0); return; }
+        {
+            lock_guard<mutex> lk(mtx);
+            job = move(f);
+            running = n - 1;
+            ++job_gen;
+        }
+        cv_job.notify_all();
+        job(0);
+        unique_lock<mutex> lk(mtx);
+        cv_done.wait(lk, [&] { return running == 0; });
+    }
+
+    // Barrier across the n threads of the current run()
+    void sync() { barrier.wait(); }
+
+    // [lo, hi) share of thread 'tid' when [0, len) is cut into n contiguous blocks
+    pair<int, int> block(int len, int tid) const {
+        return {(int)(1LL * len * tid / n), (int)(1LL * len * (tid + 1) / n)};
+    }
+
+    // Calls f(lo, hi, tid) on chunks [lo, hi) of [0, len), 'grain' indices each.
+    // Chunks start out as contiguous blocks (one per thread, visited in order),
+    // a thread whose block is done steals the remaining chunks of the others.
+    template<typename Fn>
+    void for_each(int len, int grain, Fn f) {
+        int chunks = (len + grain - 1) / grain;
+        if (n == 1 || chunks <= 1) {
+            if (len > 0) f(0, len, 0);
+            return;
+        }
+        for (int tid = 0; tid < n; ++tid) {
+            auto [lo, hi] = block(chunks, tid);
+            slots[tid].next.store(lo, memory_order_relaxed);
+            slots[tid].end = hi;
+        }
+        run([&](int tid) {
+            for (int k = 0; k < n; ++k) {
+                Slot& s = slots[(tid + k) % n];
+                for (long long c; (c = s.next.fetch_add(1, memory_order_relaxed)) < s.end; ) {
+                    f((int)(c * grain), (int)min<long long>(len, (c + 1) * grain), tid);
+                }
+            }
+        });
+    }
+};
+
+#endif
+
+/*
+Usage:
+
+void solve() {
+    int n; cin >> n;
+    vector<ll> a(n), b(n);
+    for(auto& x : a) cin >> x;
+
+    // Two passes over disjoint blocks, the second needs the whole first pass
+    ThreadPool pool(4);
+    pool.run([&](int tid) {
+        auto [lo, hi] = pool.block(n, tid);
+        for (int i = lo; i < hi; ++i) b[i] = a[i] * a[i];
+        pool.sync();
+        for (int i = lo; i < hi; ++i) a[i] = b[n - 1 - i];
+    });
+}
+*/
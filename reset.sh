@@ -4,6 +4,7 @@ set -u
 # --- Configuration ---
 DEST="Current"
 TEMPLATE_SRC="dsa_lib/template.h"
+FASTIO_SRC="dsa_lib/misc/fast_io.h"
 
 # Defaults
 MODE="CF"       # Options: CF (Numeric), ICPC (Alphabetic)
@@ -75,11 +76,13 @@ done
 echo "--- Starting Reset ($MODE Mode | $COUNT Files) ---"
 
 # --- 2. Check Template ---
-if [ ! -f "$TEMPLATE_SRC" ]; then
-    echo "ERROR: Template file not found at: $TEMPLATE_SRC"
-    echo "Current directory is: $(pwd)"
-    exit 1
-fi
+for SRC in "$TEMPLATE_SRC" "$FASTIO_SRC"; do
+    if [ ! -f "$SRC" ]; then
+        echo "ERROR: Template file not found at: $SRC"
+        echo "Current directory is: $(pwd)"
+        exit 1
+    fi
+done
 
 # --- 3. Setup Directory ---
 echo "Recreating $DEST folder..."
@@ -92,8 +95,26 @@ mkdir -p "$DEST"
 touch "$DEST/input.txt" "$DEST/output.txt"
 
 # --- 5. Define Main Logic ---
+# Prints a header without its include guard, its '#include "template.h"'
+# and everything after the closing #endif (usage comments)
+strip_header() {
+    awk '
+        { lines[NR] = $0 }
+        /^#endif/ { last = NR }
+        END {
+            for (i = 1; i < last; i++) {
+                if (i <= 2 && lines[i] ~ /^#(ifndef|define) [A-Z_]+_H$/) continue;
+                if (lines[i] ~ /^#include "template.h"/) continue;
+                print lines[i]
+            }
+        }
+    ' "$1"
+}
+
 define_body() {
     cat <<EOM
+FastIO io;
+
 void solve(){
     
 }
@@ -101,9 +122,8 @@ void solve(){
 
 
 signed main(){
-    fast;
     int t = 1;
-    cin >> t;
+    io >> t;
     while(t--){
         solve();
     }
@@ -134,8 +154,9 @@ for (( i=0; i<COUNT; i++ )); do
 
     FILE="$DEST/$NAME.cpp"
     
-    # Step A: Filter out include guards
-    grep -vE "^#ifndef CP_TEMPLATE_H|^#define CP_TEMPLATE_H|^#endif" "$TEMPLATE_SRC" > "$FILE"
+    # Step A: Template and FastIO without include guards
+    strip_header "$TEMPLATE_SRC" > "$FILE"
+    strip_header "$FASTIO_SRC" >> "$FILE"
     
     # Step B: Add exactly 10 blank lines
     for (( k=0; k<10; k++ )); do